@@ -0,0 +1,281 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+// Micro- and macro-benchmarks of the routers and the rate allocator. Every run uses the
+// same seeds, so two builds can be compared sample for sample:
+//
+//   bwr_bench [--quick] [--scale] [--filter <substring>] [--csv <file>]
+//
+// A table goes to stdout and, with --csv, one row per benchmark to the given file. With
+// --scale, generated topologies much larger than the bundled WANs are benchmarked as well.
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "router_factory.hpp"
+#include "stochastic.hpp"
+#include "tools.hpp"
+#include "topologies.hpp"
+#include "topology_generators.hpp"
+
+using namespace std;
+
+namespace Network {
+
+namespace {
+
+// Seed of every random stream in the benchmarks.
+constexpr uint64_t BENCH_SEED = 20190101;
+
+struct BenchResult {
+  string name;
+  string parameter;
+  string unit;
+  vector<double> samples;
+};
+
+struct BenchSummary {
+  double mean, p50, p90, p99, max;
+};
+
+// Time one call of func in nanoseconds.
+double TimeCall(const function<void()>& func) {
+  const auto start = chrono::steady_clock::now();
+  func();
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+BenchSummary Summarize(vector<double> samples) {
+  assert(!samples.empty());
+  sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for(const double sample : samples) {
+    sum += sample;
+  }
+  auto percentile = [&](double fraction) {
+    return samples[min(static_cast<size_t>(samples.size() * fraction), samples.size() - 1)];
+  };
+  return {sum / samples.size(), percentile(0.5), percentile(0.9), percentile(0.99), samples.back()};
+}
+
+class BenchRunner {
+public:
+  BenchRunner(bool quick, const string& filter) : quick_(quick), filter_(filter) {}
+  bool Quick() const {
+    return quick_;
+  }
+  // Whether a benchmark with this name runs at all.
+  bool Enabled(const string& name) const {
+    return filter_.empty() || name.find(filter_) != string::npos;
+  }
+  void PrintHeader() const {
+    printf("%-16s %-32s %8s %12s %12s %12s %12s %12s  %s\n", "benchmark", "parameter", "samples", "mean",
+           "p50", "p90", "p99", "max", "unit");
+  }
+  void Report(const BenchResult& result) {
+    const BenchSummary summary = Summarize(result.samples);
+    printf("%-16s %-32s %8zu %12.1f %12.1f %12.1f %12.1f %12.1f  %s\n", result.name.c_str(), 
+           result.parameter.c_str(), result.samples.size(), summary.mean, summary.p50, summary.p90, 
+           summary.p99, summary.max, result.unit.c_str());
+    fflush(stdout);
+    results_.push_back(make_pair(result, summary));
+  }
+  void WriteCSV(const string& filename) const {
+    FILE* file = fopen(filename.c_str(), "w");
+    assert(file != NULL);
+    fprintf(file, "benchmark,parameter,unit,samples,mean,p50,p90,p99,max\n");
+    for(const pair<BenchResult, BenchSummary>& entry : results_) {
+      const BenchResult& result = entry.first;
+      const BenchSummary& summary = entry.second;
+      fprintf(file, "%s,%s,%s,%zu,%.3f,%.3f,%.3f,%.3f,%.3f\n", result.name.c_str(), result.parameter.c_str(),
+              result.unit.c_str(), result.samples.size(), summary.mean, summary.p50, summary.p90, 
+              summary.p99, summary.max);
+    }
+    fclose(file);
+  }
+private:
+  const bool quick_;
+  const string filter_;
+  vector<pair<BenchResult, BenchSummary> > results_;
+};
+
+vector<Topology*> BenchTopologies(bool scale) {
+  vector<Topology*> topologies = {BuildTopologyANS(), BuildTopologyGEANT2009(), BuildTopologyGSCALE(),
+                                  BuildTopologyUNINETT2011(), BuildTopologyCOGENT()};
+  if(scale) {
+    topologies.push_back(BuildFatTree(8));
+    topologies.push_back(BuildJellyfish(500, 8, BENCH_SEED));
+    topologies.push_back(BuildGeometricWAN(1000, 5.0, BENCH_SEED));
+  }
+  return topologies;
+}
+
+// Flow with a random source and a different random destination.
+Flow RandomFlow(Topology* topo, Stochastic& random, int id, double size) {
+  const int nodes = topo->GetNodes().size();
+  const int src = random.genIndex(nodes);
+  const int dst = (src + 1 + random.genIndex(nodes - 1)) % nodes;
+  return Flow(id, topo->GetNode(src), topo->GetNode(dst), size);
+}
+
+// Latency of admitting a flow while the network keeps draining: one timeslot is simulated
+// after every few admissions so that flows complete and the active set stays bounded.
+void BenchPostFlow(BenchRunner& runner, Topology* topo) {
+  const string name = "post_flow";
+  if(!runner.Enabled(name)) {
+    return;
+  }
+  const int flows = runner.Quick() ? 100 : 500;
+  const int flows_per_slot = 2;
+  for(const RouterFactory::RouterType router_type : {
+      RouterFactory::RouterType::BWR_ROUTER_BWROPT,
+      RouterFactory::RouterType::BWR_ROUTER_BWRHF,
+      RouterFactory::RouterType::SHORTEST_PATH_ROUTER_BY_HOPS,
+      RouterFactory::RouterType::SHORTEST_PATH_ROUTER_BY_INVERSE_CAPACITY,
+      RouterFactory::RouterType::UTILIZATION_ROUTER,
+      RouterFactory::RouterType::BWR_ROUTER_BWRHF_K,
+      RouterFactory::RouterType::BWR_ROUTER_BWRHF_K_PRUNE}) {
+    FlowRouter* router = RouterFactory::BuildRouter(router_type, topo);
+    router->SetVerificationLevel(VerificationLevel::NONE);
+    Stochastic random(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, BENCH_SEED);
+    BenchResult result = {name, topo->GetName() + "/router=" + to_string(static_cast<int>(router_type)), "ns", {}};
+    for(int id = 0; id < flows; id++) {
+      const Flow flow = RandomFlow(topo, random, id, random.nextSample().second);
+      result.samples.push_back(TimeCall([&]() { router->PostFlow(flow); }));
+      if(id % flows_per_slot == flows_per_slot - 1) {
+        router->NextSlot();
+      }
+    }
+    delete router;
+    runner.Report(result);
+  }
+}
+
+// Cost of a timeslot with a given number of active flows, which never complete. Before
+// each sample one flow is admitted so that the rates are recomputed ("recompute"), the
+// following slot reuses them ("cached").
+void BenchNextSlot(BenchRunner& runner, Topology* topo) {
+  const string name = "next_slot";
+  if(!runner.Enabled(name)) {
+    return;
+  }
+  const int samples = runner.Quick() ? 20 : 100;
+  for(const int active_flows : {10, 100, 1000, 10000}) {
+    FlowRouter* router = RouterFactory::BuildRouter(RouterFactory::RouterType::SHORTEST_PATH_ROUTER_BY_HOPS, topo);
+    router->SetVerificationLevel(VerificationLevel::NONE);
+    Stochastic random(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, BENCH_SEED);
+    vector<Flow> flows;
+    for(int id = 0; id < active_flows; id++) {
+      flows.push_back(RandomFlow(topo, random, id, 1E12));
+    }
+    router->PostFlows(flows);
+    const string parameter = topo->GetName() + "/flows=" + to_string(active_flows);
+    BenchResult recompute = {name, parameter + "/recompute", "ns", {}};
+    BenchResult cached = {name, parameter + "/cached", "ns", {}};
+    for(int sample = 0; sample < samples; sample++) {
+      router->PostFlow(RandomFlow(topo, random, active_flows + sample, 1E12));
+      recompute.samples.push_back(TimeCall([&]() { router->NextSlot(); }));
+      cached.samples.push_back(TimeCall([&]() { router->NextSlot(); }));
+    }
+    delete router;
+    runner.Report(recompute);
+    runner.Report(cached);
+  }
+}
+
+// Hop-count shortest path between random pairs of nodes.
+void BenchShortestPath(BenchRunner& runner, Topology* topo) {
+  const string name = "shortest_path";
+  if(!runner.Enabled(name)) {
+    return;
+  }
+  const int samples = runner.Quick() ? 1000 : 10000;
+  Stochastic random(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, BENCH_SEED);
+  BenchResult result = {name, topo->GetName(), "ns", {}};
+  auto cost_func = [](Edge*) { return 1.0; };
+  size_t hops = 0;
+  for(int sample = 0; sample < samples; sample++) {
+    Flow flow = RandomFlow(topo, random, sample, 1.0);
+    result.samples.push_back(TimeCall([&]() {
+      hops += ComputeShortestPathGeneric(topo, &flow, cost_func).GetEdges().size();
+    }));
+  }
+  assert(hops > 0);
+  runner.Report(result);
+}
+
+// Throughput of flow sampling, one sample is the average over a batch.
+void BenchStochastic(BenchRunner& runner) {
+  const string name = "stochastic";
+  if(!runner.Enabled(name)) {
+    return;
+  }
+  const int batches = runner.Quick() ? 20 : 100;
+  const int batch = 10000;
+  for(const Stochastic::DistributionTypes dist : {
+      Stochastic::DistributionTypes::DIST_EXPONENTIAL,
+      Stochastic::DistributionTypes::DIST_PARETO,
+      Stochastic::DistributionTypes::DIST_FB_CF,
+      Stochastic::DistributionTypes::DIST_FB_HADOOP}) {
+    Stochastic random(1.0, 0.1, dist, BENCH_SEED);
+    BenchResult result = {name, "dist=" + to_string(static_cast<int>(dist)), "ns/sample", {}};
+    double sink = 0.0;
+    for(int sample = 0; sample < batches; sample++) {
+      result.samples.push_back(TimeCall([&]() {
+        for(int index = 0; index < batch; index++) {
+          sink += random.nextSample().second;
+        }
+      }) / batch);
+    }
+    assert(sink > 0.0);
+    runner.Report(result);
+  }
+}
+
+} // namespace
+
+} // namespace Network
+
+int main(int argc, char** argv) {
+  bool quick = false, scale = false;
+  string filter, csv;
+  for(int arg = 1; arg < argc; arg++) {
+    if(strcmp(argv[arg], "--quick") == 0) {
+      quick = true;
+    } else if(strcmp(argv[arg], "--scale") == 0) {
+      scale = true;
+    } else if(strcmp(argv[arg], "--filter") == 0 && arg + 1 < argc) {
+      filter = argv[++arg];
+    } else if(strcmp(argv[arg], "--csv") == 0 && arg + 1 < argc) {
+      csv = argv[++arg];
+    } else {
+      cerr << "Usage: " << argv[0] << " [--quick] [--scale] [--filter <substring>] [--csv <file>]" << endl;
+      return 1;
+    }
+  }
+  Network::BenchRunner runner(quick, filter);
+  runner.PrintHeader();
+  const vector<Network::Topology*> topologies = Network::BenchTopologies(scale);
+  for(Network::Topology* topo : topologies) {
+    Network::BenchShortestPath(runner, topo);
+  }
+  Network::BenchStochastic(runner);
+  for(Network::Topology* topo : topologies) {
+    Network::BenchNextSlot(runner, topo);
+  }
+  for(Network::Topology* topo : topologies) {
+    Network::BenchPostFlow(runner, topo);
+  }
+  if(!csv.empty()) {
+    runner.WriteCSV(csv);
+  }
+  return 0;
+}
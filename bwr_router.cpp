@@ -4,7 +4,6 @@
 
 #include <queue>
 #include <unordered_set>
-#include <set>
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -13,52 +12,57 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 #include "bwr_router.hpp"
 
 using namespace std;
 
 namespace Network {
-namespace {
-  struct DijkPath {
-    unordered_set<Edge*> path_edges;
-    vector<Node*> path;
-    unordered_set<Node*> visited;
-    unordered_set<Path*> paths;
-    double weight; // Weight of this path at the time of discovery. Needs to run set operation to update it if needed.
-    DijkPath(unordered_set<Edge*> path_edges_, vector<Node*> path_, unordered_set<Path*> paths_, double weight_) : 
-                        path_edges(move(path_edges_)), path(move(path_)), paths(move(paths_)), weight(weight_) {
-      for(Node* const node : path) {
-        visited.insert(node);
-      }
-    }
-  };
-
-  using DijkComp = function<bool(const DijkPath&, const DijkPath&)>;
-}
-
 // Get the weight for a path by using paths incident to it.
 double BWRRouter::ComputePathWeight(const unordered_set<Path*>& incident_paths, 
-                                    const unordered_set<Edge*>& path,
+                                    const Path& path,
                                     const Flow* new_flow) {
+  double next_weight = ComputePathBacklog(incident_paths, path);
+  // Add the cost for current path
+  double bottleneck = numeric_limits<double>::max();
+  for(Edge* edge : path.GetEdges()) {
+    bottleneck = min(bottleneck, edge->GetCap());
+  }
+  next_weight += new_flow->GetRemainingSize() / bottleneck;
+  return next_weight;
+}
+
+// Every flow incident to the path is charged its remaining size over the bottleneck
+// of the edges it shares with the path.
+double BWRRouter::ComputePathBacklog(const unordered_set<Path*>& incident_paths, 
+                                     const Path& path) {
+  const vector<double>& capacities = topo_->GetCSR().capacities;
+  const vector<int>& path_edges = path.GetEdgeIDs();
   unordered_map<const Flow*, double> flow_to_bottleneck;
   for(Path* const incident_path : incident_paths) {
     const Flow* flow = paths_map_[incident_path];
     if(flow_to_bottleneck.find(flow) == flow_to_bottleneck.end()) {
       flow_to_bottleneck[flow] = numeric_limits<double>::max();
     }
-    vector<Edge*> common_edges(path.size());
-    set<Edge*> sorted_path(path.begin(), path.end()), 
-               sorted_incident_path(incident_path->GetEdgesSet().begin(), incident_path->GetEdgesSet().end());
-    auto it = set_intersection(sorted_path.begin(), sorted_path.end(),
-      sorted_incident_path.begin(), sorted_incident_path.end(),
-      common_edges.begin());
-    common_edges.resize(it-common_edges.begin());
-    // There has to be common edges.
-    assert(common_edges.size() > 0);
-    for(Edge* edge : common_edges) {
-      flow_to_bottleneck[flow] = min(flow_to_bottleneck[flow], edge->GetCap());
+    double& bottleneck = flow_to_bottleneck[flow];
+    // Both id lists are sorted, walk them together to find the common edges.
+    const vector<int>& incident_edges = incident_path->GetEdgeIDs();
+    int common_edges = 0;
+    for(int index1 = 0, index2 = 0; index1 < path_edges.size() && index2 < incident_edges.size();) {
+      if(path_edges[index1] < incident_edges[index2]) {
+        index1++;
+      } else if(incident_edges[index2] < path_edges[index1]) {
+        index2++;
+      } else {
+        bottleneck = min(bottleneck, capacities[path_edges[index1]]);
+        common_edges++;
+        index1++;
+        index2++;
+      }
     }
+    // There has to be common edges.
+    assert(common_edges > 0);
   }
   // Update next weight now.
   double next_weight = 0.0;
@@ -67,101 +71,274 @@ double BWRRouter::ComputePathWeight(const unordered_set<Path*>& incident_paths,
     next_weight += flow_to_bottleneck_pair.first->GetRemainingSize() 
                       / flow_to_bottleneck_pair.second;
   }
-  // Add the cost for current path
-  double bottleneck = numeric_limits<double>::max();
-  for(Edge* edge : path) {
-    bottleneck = min(bottleneck, edge->GetCap());
-  }
-  next_weight += new_flow->GetRemainingSize() / bottleneck;
   return next_weight;
 }
 
+void BWRRouter::SetSearchBudget(long max_expansions, double time_limit) {
+  max_expansions_ = max_expansions;
+  time_limit_ = time_limit;
+}
+
+void BWRRouter::CollectEdgeFlows(int edge_id) {
+  if(edge_flows_stamp_[edge_id] == search_stamp_) {
+    return;
+  }
+  edge_flows_stamp_[edge_id] = search_stamp_;
+  edge_flows_begin_[edge_id] = edge_flows_.size();
+  Edge* const edge = topo_->GetEdges()[edge_id];
+  for(Path* const path : edges_map_[edge]) {
+    const Flow* flow = paths_map_[path];
+    edge_flows_.push_back({path->GetFlow(), flow->GetRemainingSize(), edge->GetCap()});
+  }
+  // A flow may cross the edge with several of its paths.
+  auto begin = edge_flows_.begin() + edge_flows_begin_[edge_id];
+  sort(begin, edge_flows_.end(), [](const FlowBottleneck& flow1, const FlowBottleneck& flow2) {
+    return flow1.flow < flow2.flow;
+  });
+  auto end = unique(begin, edge_flows_.end(), [](const FlowBottleneck& flow1, const FlowBottleneck& flow2) {
+    return flow1.flow == flow2.flow;
+  });
+  edge_flows_.erase(end, edge_flows_.end());
+  edge_flows_end_[edge_id] = edge_flows_.size();
+}
+
+bool BWRRouter::ExtendLabel(int label, int edge_id, int next_node, const Flow* new_flow) {
+  for(int ancestor = label; ancestor >= 0; ancestor = labels_[ancestor].parent) {
+    if(labels_[ancestor].node == next_node) {
+      return false;
+    }
+  }
+  CollectEdgeFlows(edge_id);
+  const BWRLabel parent = labels_[label];
+  const double capacity = topo_->GetCSR().capacities[edge_id];
+  // Merge the parent's flows with the flows on the edge. Only flows whose bottleneck gets
+  // tighter change the weight.
+  double weight = parent.weight;
+  const int flows_begin = label_flows_.size();
+  int index1 = parent.flows_begin, index2 = edge_flows_begin_[edge_id];
+  const int end1 = parent.flows_end, end2 = edge_flows_end_[edge_id];
+  while(index1 < end1 || index2 < end2) {
+    if(index2 == end2 || (index1 < end1 && label_flows_[index1].flow < edge_flows_[index2].flow)) {
+      const FlowBottleneck flow = label_flows_[index1++];
+      label_flows_.push_back(flow);
+    } else if(index1 == end1 || edge_flows_[index2].flow < label_flows_[index1].flow) {
+      label_flows_.push_back(edge_flows_[index2]);
+      weight += edge_flows_[index2].remaining / capacity;
+      index2++;
+    } else {
+      FlowBottleneck flow = label_flows_[index1++];
+      index2++;
+      if(capacity < flow.bottleneck) {
+        weight += flow.remaining / capacity - flow.remaining / flow.bottleneck;
+        flow.bottleneck = capacity;
+      }
+      label_flows_.push_back(flow);
+    }
+  }
+  // The new flow itself goes at the bottleneck of the path.
+  const double bottleneck = min(parent.bottleneck, capacity);
+  weight += new_flow->GetRemainingSize() / bottleneck;
+  if(parent.parent >= 0) {
+    weight -= new_flow->GetRemainingSize() / parent.bottleneck;
+  }
+  labels_.push_back({next_node, label, edge_id, weight, bottleneck, flows_begin, static_cast<int>(label_flows_.size())});
+  return true;
+}
+
+// A flow's share of the weight only grows as its bottleneck on the path gets tighter, so a
+// label whose path bottleneck and per-flow bottlenecks are all at most those of another label
+// (a flow it does not cross has an infinite bottleneck) never ends up heavier than it.
+bool BWRRouter::Dominates(const BWRLabel& label1, const BWRLabel& label2) {
+  if(label1.weight > label2.weight || label1.bottleneck > label2.bottleneck) {
+    return false;
+  }
+  int index1 = label1.flows_begin;
+  for(int index2 = label2.flows_begin; index2 < label2.flows_end; index2++) {
+    const FlowBottleneck& flow2 = label_flows_[index2];
+    while(index1 < label1.flows_end && label_flows_[index1].flow < flow2.flow) {
+      index1++;
+    }
+    if(index1 == label1.flows_end || label_flows_[index1].flow != flow2.flow ||
+       label_flows_[index1].bottleneck > flow2.bottleneck) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // This function find a path using the BWR optimal method (exhastive search but using a heap which makes it run faster).
 // Please see the research paper for more info.
+// Path weights never decrease as a path is extended, so the search expands partial paths
+// (labels) best-first and the first one to reach the destination is optimal. Labels that are
+// dominated by one already expanded at the same node are dropped.
 // The incoming flow object has only its size_ and id_ fields set, the rest is empty.
 void BWRRouter::FindPathBWROpt(Flow* new_flow) {
-  Node* const src = new_flow->GetSrc();
-  Node* const dst = new_flow->GetDst();
+  const CSRGraph& csr = topo_->GetCSR();
+  const int src = new_flow->GetSrc()->GetID();
+  const int dst = new_flow->GetDst()->GetID();
+  // Reset the scratch space.
+  search_stamp_++;
+  labels_.clear();
+  label_flows_.clear();
+  edge_flows_.clear();
+  edge_flows_begin_.resize(csr.NumEdges());
+  edge_flows_end_.resize(csr.NumEdges());
+  edge_flows_stamp_.resize(csr.NumEdges(), 0);
+  settled_.resize(csr.NumNodes());
+  settled_stamp_.resize(csr.NumNodes(), 0);
+  const auto start_time = chrono::steady_clock::now();
 
-  priority_queue<DijkPath, vector<DijkPath>, DijkComp> pq(
-    [&](const DijkPath& path1, const DijkPath& path2) {
-      return path1.weight > path2.weight;
-  });
-  pq.push(DijkPath({}, {src}, {}, 0.0));
+  using HeapItem = pair<double, int>; // <weight, label>
+  priority_queue<HeapItem, vector<HeapItem>, greater<HeapItem> > pq;
+  labels_.push_back({src, -1, -1, 0.0, numeric_limits<double>::max(), 0, 0});
+  pq.push(make_pair(0.0, 0));
+  uint64_t pushes = 1, pops = 0;
 
-  // solution of the routing algorithm
-  DijkPath pq_sol({}, {src}, {}, 0.0);
-  
-  unordered_map<int, vector<DijkPath>> sol_by_hops;
+  // Solution of the routing algorithm and the best complete path seen so far.
+  int solution = -1, best_complete = -1;
+  long expansions = 0;
 
-  while( !pq.empty() ) {
-    DijkPath current = pq.top();
+  while(!pq.empty()) {
+    const int current = pq.top().second;
     pq.pop();
+    pops++;
+    const int node = labels_[current].node;
     // If the path ends at the destination it is complete.
-    if(current.path.back() == dst) {
-      pq_sol = current;
+    if(node == dst) {
+      solution = current;
+      break;
+    }
+    if(settled_stamp_[node] != search_stamp_) {
+      settled_stamp_[node] = search_stamp_;
+      settled_[node].clear();
+    }
+    // Only compare with the lightest labels at the node, skipping a check never loses the optimum.
+    bool dominated = false;
+    for(int index = 0; index < settled_[node].size() && index < BWR_DOMINANCE_CHECKS; index++) {
+      if(Dominates(labels_[settled_[node][index]], labels_[current])) {
+        dominated = true;
+        break;
+      }
+    }
+    if(dominated) {
+      continue;
+    }
+    settled_[node].push_back(current);
+    // Stop early if the search is over budget.
+    expansions++;
+    if((max_expansions_ > 0 && expansions > max_expansions_) ||
+       (time_limit_ > 0 && (expansions & 63) == 0 && 
+        chrono::duration<double>(chrono::steady_clock::now() - start_time).count() > time_limit_)) {
+      solution = best_complete;
       break;
     }
     // Update the heap.
-    for(const pair<Edge* const, Node*>& next : topo_->GetAdjList(current.path.back())) {
-      if(current.visited.find(next.second) == current.visited.end()) {
-        // Calculate the next path's weight
-        unordered_set<Path*> incident_paths(current.paths);
-        for(Path* path : edges_map_[next.first]) {
-          incident_paths.insert(path);
-        }
-        double next_weight = ComputePathWeight(incident_paths, current.path_edges, new_flow);
-        unordered_set<Edge*> next_path_edges(current.path_edges);
-        next_path_edges.insert(next.first);
-        vector<Node*> next_path(current.path);
-        next_path.push_back(next.second);
-        DijkPath next_dijk(next_path_edges, next_path, incident_paths, next_weight);
-        pq.push(next_dijk);
+    for(int index = csr.offsets[node]; index < csr.offsets[node + 1]; index++) {
+      if(!ExtendLabel(current, csr.adj_edges[index], csr.adj_nodes[index], new_flow)) {
+        continue;
+      }
+      const int next = labels_.size() - 1;
+      // Weights only grow, nothing heavier than a complete path can beat it.
+      if(best_complete >= 0 && labels_[next].weight >= labels_[best_complete].weight) {
+        label_flows_.resize(labels_[next].flows_begin);
+        labels_.pop_back();
+        continue;
+      }
+      pq.push(make_pair(labels_[next].weight, next));
+      pushes++;
+      if(csr.adj_nodes[index] == dst) {
+        best_complete = next;
       }
     }
   }
+  Count(Counter::HEAP_PUSHES, pushes);
+  Count(Counter::HEAP_POPS, pops);
+  if(solution < 0) {
+    // Over budget before any path reached the destination.
+    FindPathBWRHF(new_flow);
+    return;
+  }
+  vector<int> reversed_edges;
+  for(int label = solution; labels_[label].parent >= 0; label = labels_[label].parent) {
+    reversed_edges.push_back(labels_[label].edge);
+  }
   Path output(new_flow->GetID());
-  for(int i = 1; i < pq_sol.path.size(); i++) {
-    output.AddEdge(topo_->GetEdge(pq_sol.path[i-1], pq_sol.path[i]));
+  for(auto it = reversed_edges.rbegin(); it != reversed_edges.rend(); it++) {
+    output.AddEdge(topo_->GetEdges()[*it]);
   }
   InstallPath(new_flow, output);
 }
 
+double BWRRouter::GetEdgeCostBWRHF(const Flow* new_flow, Edge* edge) {
+  return (new_flow->GetRemainingSize() + GetEdgeRemainingDemand(edge)) / edge->GetCap();
+}
+
 // This implements the BWRHF heuristic that is basically Dijkstra with weights assigned according to flow sizes.
 void BWRRouter::FindPathBWRHF(Flow* new_flow) {
   // Wrapper around the generic shortest path callback.
-  function<double(Edge*)> cost_func = [&](Edge* edge) {
-    // Compute edge cost here.
-    double edge_cost = (new_flow->GetRemainingSize() / edge->GetCap());
-    for(Path* const path : edges_map_[edge]) {
-      Flow* const flow = paths_map_.find(path)->second;
-      edge_cost += (flow->GetRemainingSize() / edge->GetCap());
-    }
-    return edge_cost;
+  auto cost_func = [&](Edge* edge) {
+    return GetEdgeCostBWRHF(new_flow, edge);
   };
-  Path* new_path = new Path(ComputeShortestPathGeneric(topo_, new_flow, cost_func));
-  new_flow->AddPath(new_path);
-  paths_map_[new_path] = new_flow;
-  for(Edge* const edge : new_path->GetEdges()) {
-    edges_map_[edge].push_back(new_path);
-  }
+  InstallPath(new_flow, ComputeShortestPathGeneric(topo_, new_flow, cost_func));
 }
 
-void BWRRouter::InstallPath(Flow* new_flow, const Path& path) {
-  Path* new_path = new Path(path);
-  new_flow->AddPath(new_path);
-  paths_map_[new_path] = new_flow;
-  for(Edge* const edge : new_path->GetEdges()) {
-    edges_map_[edge].push_back(new_path);
+// Capture up to max_paths_ edge-disjoint paths for the new flow. Each one is the BWRHF path
+// over the topology without the edges of the paths captured before it, so they come out in
+// order of increasing weight.
+void BWRRouter::CaptureK(Flow* new_flow, vector<Path>& paths) {
+  vector<bool> captured(topo_->GetEdges().size(), false);
+  auto cost_func = [&](Edge* edge) {
+    return captured[edge->GetID()] ? 
+      numeric_limits<double>::infinity() : GetEdgeCostBWRHF(new_flow, edge);
+  };
+  while(paths.size() < max_paths_) {
+    Path path = ComputeShortestPathGeneric(topo_, new_flow, cost_func);
+    if(path.GetEdges().empty()) {
+      break;
+    }
+    for(Edge* const edge : path.GetEdges()) {
+      captured[edge->GetID()] = true;
+    }
+    paths.push_back(path);
   }
 }
 
-void BWRRouter::PostFlow(Flow flow) {
-  assert(flow.GetSrc() != flow.GetDst());
-
-  Flow* new_flow = new Flow(flow);
-  flows_map_[new_flow->GetID()] = new_flow;
+// Capture k paths and prune the ones that do not lower the worst-case completion time of
+// the new flow. In the worst case the new flow gets path i only after the flows already on
+// it are done (its backlog W_i) and then at the path's bottleneck capacity c_i. Splitting
+// the flow's volume V over a set of disjoint paths finishes it by T = (V + sum c_i W_i) / sum c_i,
+// so paths are taken by increasing backlog for as long as the next one has W_i < T.
+void BWRRouter::CaptureAndPrune(Flow* new_flow, vector<Path>& paths) {
+  CaptureK(new_flow, paths);
+  vector<pair<double, int> > backlogs;
+  for(int index = 0; index < paths.size(); index++) {
+    unordered_set<Path*> incident_paths;
+    for(Edge* const edge : paths[index].GetEdges()) {
+      for(Path* const path : edges_map_[edge]) {
+        incident_paths.insert(path);
+      }
+    }
+    backlogs.push_back(make_pair(ComputePathBacklog(incident_paths, paths[index]), index));
+  }
+  sort(backlogs.begin(), backlogs.end());
+  vector<Path> kept;
+  double total_cap = 0.0, weighted_backlog = 0.0;
+  for(pair<double, int>& backlog : backlogs) {
+    Path& path = paths[backlog.second];
+    if(!kept.empty()) {
+      const double completion_time = (new_flow->GetRemainingSize() + weighted_backlog) / total_cap;
+      if(backlog.first >= completion_time) {
+        break;
+      }
+    }
+    total_cap += path.GetBottleneckCap();
+    weighted_backlog += path.GetBottleneckCap() * backlog.first;
+    kept.push_back(path);
+  }
+  paths.swap(kept);
+}
 
+void BWRRouter::RouteFlow(Flow* new_flow) {
   switch(tech_) {
     case TECHNIQUE::BWROPT: {
         FindPathBWROpt(new_flow);
@@ -171,11 +348,25 @@ void BWRRouter::PostFlow(Flow flow) {
         FindPathBWRHF(new_flow);
         break;
       }
+    case TECHNIQUE::BWRHF_K: {
+        vector<Path> paths;
+        CaptureK(new_flow, paths);
+        for(const Path& path : paths) {
+          InstallPath(new_flow, path);
+        }
+        break;
+      }
+    case TECHNIQUE::BWRHF_K_PRUNE: {
+        vector<Path> paths;
+        CaptureAndPrune(new_flow, paths);
+        for(const Path& path : paths) {
+          InstallPath(new_flow, path);
+        }
+        break;
+      }
     default:
       assert(false);
   }
-
-  VerifyConsistency();
 }
 
 } // namespace Network
\ No newline at end of file
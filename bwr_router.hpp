@@ -15,24 +15,80 @@ using namespace std;
 
 namespace Network {
 
+// Maximum number of paths captured per flow by the multipath techniques.
+constexpr int BWR_MAX_PATHS = 4;
+
+// Maximum number of labels a BWROPT label is checked against for dominance at a node.
+constexpr int BWR_DOMINANCE_CHECKS = 16;
+
+// Expansion budget of the BWROPT search for routers built by RouterFactory. The exact
+// search is exponential in the worst case and runs out of memory on the larger WANs.
+constexpr long BWR_OPT_MAX_EXPANSIONS = 100000;
+
 class BWRRouter : public FlowRouter {
 public:
   enum class TECHNIQUE {
-    BWROPT, BWRHF
+    BWROPT, BWRHF,
+    // Multipath: up to max_paths edge-disjoint BWRHF paths per flow.
+    BWRHF_K,
+    // Multipath: as above but only keep the paths that lower the worst-case completion time.
+    BWRHF_K_PRUNE
   };
-  BWRRouter(Topology* topo, TECHNIQUE tech) : 
-            FlowRouter(topo), tech_(tech) {}
-  void PostFlow(Flow flow);
+  BWRRouter(Topology* topo, TECHNIQUE tech, int max_paths = BWR_MAX_PATHS) : 
+            FlowRouter(topo), tech_(tech), max_paths_(max_paths),
+            max_expansions_(0), time_limit_(0.0), search_stamp_(0) {}
+  // Limit the BWROPT search per flow to a number of label expansions and/or a wall-clock
+  // time in seconds (zero means no limit). When the budget runs out the best complete
+  // path found so far is used, or the BWRHF path if none was found.
+  void SetSearchBudget(long max_expansions, double time_limit);
 protected:
+  void RouteFlow(Flow* new_flow) override;
+  // Partial path in the BWROPT search. Its weight is kept up to date incrementally: the
+  // label stores, sorted by flow id, the bottleneck of the edges it shares with every
+  // flow it crosses (see ComputePathWeight).
+  struct BWRLabel {
+    int node;
+    int parent; // Label this one extends, -1 at the source.
+    int edge;   // Edge from the parent's node to this node.
+    double weight;
+    double bottleneck; // Bottleneck capacity of the path itself.
+    int flows_begin, flows_end; // Range in label_flows_.
+  };
+  struct FlowBottleneck {
+    int flow;
+    double remaining; // Remaining size of the flow.
+    double bottleneck;
+  };
   TECHNIQUE tech_;
+  const int max_paths_;
+  long max_expansions_;
+  double time_limit_;
+  // Scratch space of the BWROPT search kept across flows.
+  vector<BWRLabel> labels_;
+  vector<FlowBottleneck> label_flows_;
+  vector<int> edge_flows_begin_, edge_flows_end_, edge_flows_stamp_;
+  vector<FlowBottleneck> edge_flows_; // Flows crossing each edge, sorted by flow id.
+  vector<vector<int> > settled_;      // Non-dominated labels expanded at each node.
+  vector<int> settled_stamp_;
+  int search_stamp_;
   void FindPathBWROpt(Flow* new_flow);
+  // Flows crossing an edge, collected once per search.
+  void CollectEdgeFlows(int edge_id);
+  // Extend a label over an edge, returns false if that would close a loop.
+  bool ExtendLabel(int label, int edge_id, int next_node, const Flow* new_flow);
+  // A label dominates another at the same node if every extension of it weighs at most as much.
+  bool Dominates(const BWRLabel& label1, const BWRLabel& label2);
   void FindPathBWRHF(Flow* new_flow);
+  // Edge cost used by BWRHF: time to send the new flow and all flows already on the edge.
+  double GetEdgeCostBWRHF(const Flow* new_flow, Edge* edge);
   void CaptureK(Flow* new_flow, vector<Path>& paths);
   void CaptureAndPrune(Flow* new_flow, vector<Path>& paths);
   double ComputePathWeight(const unordered_set<Path*>& incident_paths, 
-    const unordered_set<Edge*>& path, const Flow* new_flow);
+    const Path& path, const Flow* new_flow);
+  // Worst-case time until the flows already crossing the path are done with it.
+  double ComputePathBacklog(const unordered_set<Path*>& incident_paths, 
+    const Path& path);
   // double ComputePathWeight(const Path* path);
-  void InstallPath(Flow* new_flow, const Path& path);
 };
 
 } // namespace Network
@@ -0,0 +1,104 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "flow_progress.hpp"
+
+namespace Network {
+
+ProgressSummary AdvanceFlows(double* completed, const double* size, const double* rate, int flows,
+                             double duration, double cap_duration) {
+  const bool check_cap = !isinf(cap_duration);
+  bool any_completed = false, any_capped = false;
+  int index = 0;
+#if defined(__AVX512F__)
+  const __m512d step = _mm512_set1_pd(duration), cap = _mm512_set1_pd(cap_duration);
+  const __m512d epsilon = _mm512_set1_pd(FLOW_COMPLETION_EPSILON), zero = _mm512_setzero_pd();
+  __mmask8 completed_mask = 0, capped_mask = 0;
+  for(; index + 8 <= flows; index += 8) {
+    const __m512d flow_rate = _mm512_loadu_pd(rate + index);
+    const __m512d sent = _mm512_add_pd(_mm512_loadu_pd(completed + index), _mm512_mul_pd(flow_rate, step));
+    _mm512_storeu_pd(completed + index, sent);
+    const __m512d remaining = _mm512_max_pd(_mm512_sub_pd(_mm512_loadu_pd(size + index), sent), zero);
+    const __mmask8 done = _mm512_cmp_pd_mask(remaining, epsilon, _CMP_LT_OQ);
+    completed_mask |= done;
+    capped_mask |= ~done & _mm512_cmp_pd_mask(flow_rate, _mm512_div_pd(remaining, cap), _CMP_GT_OQ);
+  }
+  any_completed = completed_mask != 0;
+  any_capped = check_cap && capped_mask != 0;
+#elif defined(__AVX2__)
+  const __m256d step = _mm256_set1_pd(duration), cap = _mm256_set1_pd(cap_duration);
+  const __m256d epsilon = _mm256_set1_pd(FLOW_COMPLETION_EPSILON), zero = _mm256_setzero_pd();
+  __m256d completed_mask = zero, capped_mask = zero;
+  for(; index + 4 <= flows; index += 4) {
+    const __m256d flow_rate = _mm256_loadu_pd(rate + index);
+    const __m256d sent = _mm256_add_pd(_mm256_loadu_pd(completed + index), _mm256_mul_pd(flow_rate, step));
+    _mm256_storeu_pd(completed + index, sent);
+    const __m256d remaining = _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(size + index), sent), zero);
+    const __m256d done = _mm256_cmp_pd(remaining, epsilon, _CMP_LT_OQ);
+    completed_mask = _mm256_or_pd(completed_mask, done);
+    capped_mask = _mm256_or_pd(capped_mask,
+      _mm256_andnot_pd(done, _mm256_cmp_pd(flow_rate, _mm256_div_pd(remaining, cap), _CMP_GT_OQ)));
+  }
+  any_completed = _mm256_movemask_pd(completed_mask) != 0;
+  any_capped = check_cap && _mm256_movemask_pd(capped_mask) != 0;
+#endif
+  for(; index < flows; index++) {
+    completed[index] += rate[index] * duration;
+    const double remaining = max(size[index] - completed[index], 0.0);
+    if(remaining < FLOW_COMPLETION_EPSILON) {
+      any_completed = true;
+    } else if(check_cap && rate[index] > remaining / cap_duration) {
+      any_capped = true;
+    }
+  }
+  return ProgressSummary{any_completed, any_capped};
+}
+
+double EarliestCompletion(const double* completed, const double* size, const double* rate, int flows) {
+  double earliest = numeric_limits<double>::infinity();
+  int index = 0;
+#if defined(__AVX512F__)
+  const __m512d zero = _mm512_setzero_pd();
+  __m512d earliest_lanes = _mm512_set1_pd(earliest);
+  for(; index + 8 <= flows; index += 8) {
+    const __m512d flow_rate = _mm512_loadu_pd(rate + index);
+    const __m512d remaining = _mm512_max_pd(
+      _mm512_sub_pd(_mm512_loadu_pd(size + index), _mm512_loadu_pd(completed + index)), zero);
+    const __mmask8 sending = _mm512_cmp_pd_mask(flow_rate, zero, _CMP_GT_OQ);
+    earliest_lanes = _mm512_mask_min_pd(earliest_lanes, sending, earliest_lanes,
+      _mm512_div_pd(remaining, flow_rate));
+  }
+  earliest = _mm512_reduce_min_pd(earliest_lanes);
+#elif defined(__AVX2__)
+  const __m256d zero = _mm256_setzero_pd(), infinity = _mm256_set1_pd(earliest);
+  __m256d earliest_lanes = infinity;
+  for(; index + 4 <= flows; index += 4) {
+    const __m256d flow_rate = _mm256_loadu_pd(rate + index);
+    const __m256d remaining = _mm256_max_pd(
+      _mm256_sub_pd(_mm256_loadu_pd(size + index), _mm256_loadu_pd(completed + index)), zero);
+    const __m256d sending = _mm256_cmp_pd(flow_rate, zero, _CMP_GT_OQ);
+    earliest_lanes = _mm256_min_pd(earliest_lanes,
+      _mm256_blendv_pd(infinity, _mm256_div_pd(remaining, flow_rate), sending));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, earliest_lanes);
+  earliest = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+#endif
+  for(; index < flows; index++) {
+    if(rate[index] > 0.0) {
+      earliest = min(earliest, max(size[index] - completed[index], 0.0) / rate[index]);
+    }
+  }
+  return earliest;
+}
+
+} // namespace Network
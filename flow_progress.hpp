@@ -0,0 +1,36 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef FLOW_PROGRESS_HPP
+#define FLOW_PROGRESS_HPP
+
+using namespace std;
+
+namespace Network {
+
+// A flow with less than this much left to send is complete.
+constexpr double FLOW_COMPLETION_EPSILON = 1E-6;
+
+// Kernels over flow state kept as a structure of arrays: flow i has sent completed[i] of
+// size[i] and is sending at rate[i]. They use AVX-512 or AVX2 when the build targets it
+// (e.g. -march=native, see BWR_NATIVE_SIMD in CMakeLists.txt) and a scalar loop otherwise.
+// Every lane does the same operations as the scalar loop, so the results do not depend on
+// the instruction set.
+
+struct ProgressSummary {
+  bool completed; // Some flow is complete after the step.
+  bool capped;    // Some incomplete flow has less left than its rate sends in cap_duration.
+};
+
+// Advance every flow by duration at its rate (completed[i] += rate[i] * duration).
+// An infinite cap_duration never caps.
+ProgressSummary AdvanceFlows(double* completed, const double* size, const double* rate, int flows,
+                             double duration, double cap_duration);
+
+// Time until the first flow that is sending completes at its rate, infinity if none is.
+double EarliestCompletion(const double* completed, const double* size, const double* rate, int flows);
+
+} // namespace Network
+
+#endif // FLOW_PROGRESS_HPP
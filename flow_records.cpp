@@ -0,0 +1,111 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include "flow_records.hpp"
+
+namespace Network {
+
+FlowRecordWriter::FlowRecordWriter(const string& filename, Topology* topo) :
+  filename_(filename), file_(CreateRecordFile(filename)), topo_(topo), count_(0) {
+  buffer_.reserve(FLOW_RECORDS_BUFFER);
+}
+
+FlowRecordWriter::~FlowRecordWriter() {
+  try {
+    Close();
+  } catch(const runtime_error& error) {
+    cerr << error.what() << endl;
+  }
+}
+
+void FlowRecordWriter::Write(Flow* flow, double completion) {
+  assert(file_ != NULL);
+  const vector<Path*>& paths = flow->GetPaths();
+  assert(!paths.empty());
+  const int src = flow->GetSrc()->GetID();
+  const int dst = flow->GetDst()->GetID();
+  FlowRecord record;
+  record.arrival = flow->GetArrival();
+  record.completion = completion;
+  record.size = flow->GetSize();
+  record.ideal_fct = flow->GetSize() / WidestPaths(src)[dst];
+  record.id = flow->GetID();
+  record.src = src;
+  record.dst = dst;
+  record.hops = paths[0]->GetEdges().size();
+  record.paths = paths.size();
+  buffer_.push_back(record);
+  count_++;
+  if(buffer_.size() == FLOW_RECORDS_BUFFER) {
+    Flush();
+  }
+}
+
+void FlowRecordWriter::Close() {
+  if(file_ == NULL) {
+    return;
+  }
+  Flush();
+  FILE* const file = file_;
+  file_ = NULL;
+  CloseRecordFile(file, filename_, FLOW_RECORDS_MAGIC, FLOW_RECORDS_VERSION, sizeof(FlowRecord), count_);
+}
+
+void FlowRecordWriter::Flush() {
+  if(buffer_.empty()) {
+    return;
+  }
+  const size_t written = fwrite(buffer_.data(), sizeof(FlowRecord), buffer_.size(), file_);
+  const bool failed = written != buffer_.size();
+  // Dropped either way, so closing after a failure does not write them again.
+  buffer_.clear();
+  if(failed) {
+    throw runtime_error(filename_ + ": cannot write the flow records");
+  }
+}
+
+// Dijkstra where the length of a path is its smallest capacity and longer is better.
+const vector<double>& FlowRecordWriter::WidestPaths(int src) {
+  const CSRGraph& csr = topo_->GetCSR();
+  if(widest_paths_.empty()) {
+    widest_paths_.resize(csr.NumNodes());
+  }
+  vector<double>& widest = widest_paths_[src];
+  if(!widest.empty()) {
+    return widest;
+  }
+  widest.assign(csr.NumNodes(), 0.0);
+  widest[src] = numeric_limits<double>::infinity();
+  priority_queue<pair<double, int> > pq; // <bottleneck, node>, widest first.
+  pq.push(make_pair(widest[src], src));
+  while(!pq.empty()) {
+    const pair<double, int> top = pq.top();
+    pq.pop();
+    const int node = top.second;
+    if(top.first < widest[node]) {
+      continue;
+    }
+    for(int index = csr.offsets[node]; index < csr.offsets[node + 1]; index++) {
+      const int next = csr.adj_nodes[index];
+      const double bottleneck = min(widest[node], csr.capacities[csr.adj_edges[index]]);
+      if(bottleneck > widest[next]) {
+        widest[next] = bottleneck;
+        pq.push(make_pair(bottleneck, next));
+      }
+    }
+  }
+  return widest;
+}
+
+MappedFlowRecords::MappedFlowRecords(const string& filename) :
+  MappedRecordFile(filename, FLOW_RECORDS_MAGIC, FLOW_RECORDS_VERSION, sizeof(FlowRecord)) {}
+
+} // namespace Network
@@ -0,0 +1,87 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef FLOW_RECORDS_HPP
+#define FLOW_RECORDS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "tools.hpp"
+#include "topology.hpp"
+#include "trace.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Binary per-flow results of a run: a TraceHeader (see trace.hpp) followed by `count`
+// FlowRecord records in completion order, in the byte order of the machine that wrote it.
+constexpr char FLOW_RECORDS_MAGIC[8] = {'B', 'W', 'R', 'F', 'L', 'O', 'W', 'S'};
+constexpr uint32_t FLOW_RECORDS_VERSION = 1;
+// Records buffered by FlowRecordWriter between two writes to the file.
+constexpr int FLOW_RECORDS_BUFFER = 4096;
+
+struct FlowRecord {
+  double arrival;
+  double completion;
+  double size;
+  // Completion time of the flow alone on the empty network: its size over the bottleneck
+  // capacity of the widest path between its end nodes.
+  double ideal_fct;
+  int32_t id;
+  int32_t src, dst;
+  int16_t hops;  // Edges on the first path of the flow.
+  int16_t paths; // Paths the flow was routed on.
+  double GetFCT() const {
+    return completion - arrival;
+  }
+  double GetSlowdown() const {
+    return GetFCT() / ideal_fct;
+  }
+};
+
+static_assert(is_trivially_copyable<FlowRecord>::value && sizeof(FlowRecord) == 48,
+              "FlowRecord is the on-disk record of a flow records file");
+
+// Writes the records of completed flows of one run on a topology to a new file, through a
+// buffer of FLOW_RECORDS_BUFFER records. The count in the header is filled in on Close.
+// Write errors throw runtime_error as in TraceWriter.
+class FlowRecordWriter {
+public:
+  FlowRecordWriter(const string& filename, Topology* topo);
+  ~FlowRecordWriter();
+  // Record a flow that completed at the given time (see FlowRouter::SetCompletionCallback).
+  void Write(Flow* flow, double completion);
+  void Close();
+private:
+  void Flush();
+  // Bottleneck capacity of the widest path from src to every node, cached per src.
+  const vector<double>& WidestPaths(int src);
+  const string filename_;
+  FILE* file_;
+  Topology* const topo_;
+  uint64_t count_;
+  vector<FlowRecord> buffer_;
+  vector<vector<double> > widest_paths_;
+};
+
+// Read-only mapping of a flow records file.
+class MappedFlowRecords : public MappedRecordFile {
+public:
+  explicit MappedFlowRecords(const string& filename);
+  const FlowRecord* begin() const {
+    return static_cast<const FlowRecord*>(records_);
+  }
+  const FlowRecord* end() const {
+    return begin() + count_;
+  }
+};
+
+} // namespace Network
+
+#endif // FLOW_RECORDS_HPP
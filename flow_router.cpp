@@ -4,11 +4,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <functional>
-#include <queue>
 #include <limits>
+#include <stdexcept>
 
+#include "flow_progress.hpp"
 #include "flow_router.hpp"
 
 namespace Network {
@@ -22,268 +24,344 @@ void PathsPrint(Path* p) {
   cout << endl;
 }
 
+// Whether any of the paths in [begin, end) goes over the edge.
+bool AnyPathContains(vector<Path*>::const_iterator begin, vector<Path*>::const_iterator end, Edge* edge) {
+  for(auto it = begin; it != end; it++) {
+    if((*it)->Contains(edge)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-FlowRouter::~FlowRouter() {
-	// Release memory for completed flows.
-	for(auto& flow_pair : flow_completion_times_) {
-		for(Path* const path : flow_pair.first->GetPaths()) {
-			delete path;
-		}
-		delete flow_pair.first;
+}
+
+// Flows and paths are released with their pools.
+FlowRouter::~FlowRouter() {}
+
+Flow* FlowRouter::NewFlow(const Flow& flow) {
+	Count(Counter::FLOW_ALLOCATIONS);
+	return flow_pool_.New(flow);
+}
+
+Path* FlowRouter::NewPath(const Path& path) {
+	Count(Counter::PATH_ALLOCATIONS);
+	return path_pool_.New(path);
+}
+
+void FlowRouter::AdmitFlow(const Flow& flow) {
+	PhaseTimer timer(Phase::ROUTING);
+	// Routing looks at what the other flows have left.
+	SyncFlows();
+	Flow* new_flow = NewFlow(flow);
+	assert(new_flow->GetSrc() != new_flow->GetDst());
+	flows_map_[new_flow->GetID()] = new_flow;
+	RouteFlow(new_flow);
+	// The destination is unreachable, the flow would never complete.
+	if(new_flow->GetPaths().empty()) {
+		flows_map_.erase(new_flow->GetID());
+		flow_pool_.Recycle(new_flow);
+		unroutable_flows_++;
+		return;
 	}
-	// Release memory for incomplete flows.
-	for(pair<Path* const, Flow*>& pair : paths_map_) {
-		delete pair.first;
+	generation_++;
+}
+
+void FlowRouter::PostFlow(Flow flow) {
+	InstrumentationScope scope(instrumentation_);
+	AdmitFlow(flow);
+	CheckConsistency();
+}
+
+void FlowRouter::PostFlows(const vector<Flow>& flows) {
+	InstrumentationScope scope(instrumentation_);
+	for(const Flow& flow : flows) {
+		AdmitFlow(flow);
 	}
-	for(pair<int const, Flow*>& pair : flows_map_) {
-		delete pair.second;
+	if(!flows.empty()) {
+		CheckConsistency();
 	}
 }
 
+Path* FlowRouter::InstallPath(Flow* flow, const Path& path) {
+	if(path.GetEdges().empty()) {
+		return NULL;
+	}
+	Path* new_path = NewPath(path);
+	flow->AddPath(new_path);
+	paths_map_[new_path] = flow;
+	const size_t num_edges = topo_->GetEdges().size();
+	if(edge_remaining_demand_.size() < num_edges) {
+		edge_remaining_demand_.resize(num_edges, 0.0);
+		edge_active_flows_.resize(num_edges, 0);
+	}
+	const vector<Path*>& flow_paths = flow->GetPaths();
+	for(Edge* const edge : new_path->GetEdges()) {
+		edges_map_[edge].push_back(new_path);
+		edge_remaining_demand_[edge->GetID()] += flow->GetRemainingSize();
+		// The flow counts once on an edge that its other paths share.
+		if(!AnyPathContains(flow_paths.begin(), flow_paths.end() - 1, edge)) {
+			edge_active_flows_[edge->GetID()]++;
+		}
+	}
+	return new_path;
+}
+
 double FlowRouter::getEpoch() {
 	return time_;
 }
 
 // Compute transmission rates per path per flow and then update progress by one timeslot.
 // This implements max-min fairness: (traffic is shifted to shorter paths in multipath mode)
-unordered_map<Path*, double> FlowRouter::NextSlot() {
+const unordered_map<Path*, double>& FlowRouter::NextSlot() {
+	InstrumentationScope scope(instrumentation_);
 	// Next timeslot.
 	time_ += TIMESLOT_DURATION;
-	// Lookup tables.
-	unordered_map<Edge*, unordered_map<Flow*, double> > edge_flow_utilization;
-	unordered_map<Edge*, unordered_map<Flow*, unordered_map<Path*, double> > > edge_flow_path_allocated;
-	unordered_map<Edge*, unordered_set<Flow*> > edge_flow_map;
-	// Add all paths and order them by length.
-	using Comparator = function<bool(Path* const, Path* const)>;
-	map<Path*, Flow*, Comparator> ordered_flow_paths_by_length(
-		[](Path* const p1, Path* const p2) {
-			return (p1->GetEdges().size() < p2->GetEdges().size()) || 
-				((p1->GetEdges().size() == p2->GetEdges().size()) && (p1 < p2));
-		});
-	for(auto& pair : paths_map_) {
-		Path* const path = pair.first;
-		Flow* const flow = pair.second;
-		ordered_flow_paths_by_length.insert(make_pair(path, flow));
+	// Compute fair shares by progressive filling (see water_filling.hpp).
+	const unordered_map<Path*, double>& path_allocated_rate = ComputeRates(TIMESLOT_DURATION);
+	Transmit(TIMESLOT_DURATION);
+	// Return the path rates.
+	return path_allocated_rate;
+}
+
+// Compute max-min fair rates without the per-timeslot demand cap and advance the epoch
+// straight to the next event: either the next flow arrival or the first flow completion.
+const unordered_map<Path*, double>& FlowRouter::NextEvent(double next_arrival) {
+	InstrumentationScope scope(instrumentation_);
+	assert(next_arrival >= time_);
+	const unordered_map<Path*, double>& path_allocated_rate = ComputeRates(numeric_limits<double>::infinity());
+	// Find the earliest completion under the current rates.
+	double duration = next_arrival - time_;
+	{
+		PhaseTimer timer(Phase::TRANSMISSION);
+		duration = min(duration, EarliestCompletion(step_completed_.data(), 
+			step_size_.data(), step_rate_.data(), step_flows_.size()));
 	}
-	for(Edge* const edge : topo_->GetEdges()) {
-		for(Path* const path : edges_map_[edge]) {
-			Flow* const flow = paths_map_[path];
-			assert(find(flow->GetPaths().begin(), flow->GetPaths().end(), path) != flow->GetPaths().end());
-			edge_flow_path_allocated[edge][flow][path] = -1.0;
+	if(duration == numeric_limits<double>::infinity()) {
+		// Idle for good, e.g. the last flows to arrive had no path.
+		if(flows_map_.empty()) {
+			return path_allocated_rate;
 		}
+		// Nothing is ever going to happen otherwise.
+		throw runtime_error("NextEvent: no flow can make progress and no flow is going to arrive");
 	}
-	// Compute fair shares.
-	// Main loop of this algorithm, iterate over paths (groups of shortest paths among all existing).
-	/////////////////////////////////////////////////////////////////////////////////////////////////
-	for(;;) {
-		// cout << "LOOP-------------------------------------------" << endl << endl;
-		// Compute fair share per flow (not per path) per edge, find the edge with minimum fair share.
-		tuple<Edge*, Flow*, double> flow_with_min_share = {NULL, NULL, numeric_limits<double>::max()};
-		for(Edge* const edge : topo_->GetEdges()) {
-			// cout << " [" << edge->GetSrc()->GetID() << ", " << edge->GetDst()->GetID() << "]:" << endl;
-			unordered_set<Flow*> active_flows;
-			unordered_map<Flow*, double> utilization;
-			for(auto& pair : edge_flow_path_allocated[edge]) {
-				Flow* const flow = pair.first;
-				utilization[flow] = 0.0;
-				for(auto& ppair : pair.second) {
-					Path* const path = ppair.first;
-					const double allocated = ppair.second;
-					if(allocated > 0) {
-						// cout << "Allocated: " << allocated << " --> ";
-						// PathsPrint(path);
-						utilization[flow] += allocated;
-					}
-					if(allocated < -0.5) {
-						active_flows.insert(flow);
-					}
-				}
-			}
-			if(active_flows.empty()) {
-				continue;
-			}
-			double remaining_capacity = edge->GetCap();
-			for(auto& pair : utilization) {
-				// cout << "Flow: [" << 
-				// 	pair.first->GetSrc()->GetID() << ", " << pair.first->GetDst()->GetID() << "] " <<
-				// 	pair.second << endl;
-				if(active_flows.find(pair.first) == active_flows.end()) {
-					remaining_capacity -= pair.second;
-				}
-			}
-			assert(remaining_capacity > -1E-6);
-			if(remaining_capacity < 1E-6) {
+	time_ += duration;
+	Transmit(duration);
+	return path_allocated_rate;
+}
+
+const unordered_map<Path*, double>& FlowRouter::ComputeRates(double duration) {
+	// The demand cap is the same one WaterFilling applies, a flow that has less left than
+	// its rate would send is capped and the rates have to be recomputed.
+	if(rates_generation_ == generation_ && rates_duration_ == duration && !rates_capped_) {
+		Count(Counter::RATE_REUSES);
+		return rates_;
+	}
+	PhaseTimer timer(Phase::RATE_ALLOCATION);
+	Count(Counter::RATE_RECOMPUTES);
+	SyncFlows();
+	rates_ = water_filling_.Allocate(flows_map_, duration);
+	rates_generation_ = generation_;
+	rates_duration_ = duration;
+	rates_capped_ = false;
+	// Lay out the flows for Transmit. Walk the paths through the flows rather than the rate map:
+	// the map is keyed by pointer, so its order (and thus the rounding of the sums) would depend
+	// on where the paths were allocated.
+	const CSRGraph& csr = topo_->GetCSR();
+	step_flows_.clear();
+	step_size_.clear();
+	step_completed_.clear();
+	step_rate_.clear();
+	edge_load_.assign(csr.NumEdges(), 0.0);
+	edge_drain_.assign(csr.NumEdges(), 0.0);
+	if(edge_remaining_demand_.size() < static_cast<size_t>(csr.NumEdges())) {
+		edge_remaining_demand_.resize(csr.NumEdges(), 0.0);
+		edge_active_flows_.resize(csr.NumEdges(), 0);
+	}
+	for(pair<const int, Flow*>& flow_pair : flows_map_) {
+		Flow* const flow = flow_pair.second;
+		double flow_rate = 0.0;
+		for(Path* const path : flow->GetPaths()) {
+			const auto allocation = rates_.find(path);
+			if(allocation == rates_.end()) {
 				continue;
 			}
-			const double edge_fair_share = remaining_capacity / active_flows.size();
-			for(Flow* const flow : active_flows) {
-				// cout << "Share: " << edge_fair_share << " Utilization: " << utilization[flow] << endl;
-				assert(edge_fair_share - utilization[flow] > -1E-6);
-				double flow_fair_share = min(
-					max(edge_fair_share - utilization[flow], 0.0), 
-						flow->GetRemainingSize() / TIMESLOT_DURATION);
-				if(get<2>(flow_with_min_share) > flow_fair_share) {
-					get<0>(flow_with_min_share) = edge;
-					get<1>(flow_with_min_share) = flow;
-					get<2>(flow_with_min_share) = flow_fair_share;
-				}
+			for(const int edge_id : path->GetEdgeIDs()) {
+				edge_load_[edge_id] += allocation->second;
 			}
+			flow_rate += allocation->second;
 		}
-		// Any edge with minimum fair share?
-		if(get<0>(flow_with_min_share) == NULL) {
-			break;
-		}
-		// Now distribute the capacity across paths by length (shortest paths get the highest rates).
-		Edge* const min_edge = get<0>(flow_with_min_share);
-		Flow* const min_flow = get<1>(flow_with_min_share);
-		const double min_share = get<2>(flow_with_min_share);
-		// Extract min-hop paths for this edge/flow pair.
-		vector<Path*> min_paths, longer_paths;
-		for(const pair<Path* const, Flow*> pair : ordered_flow_paths_by_length) {
-			Path* const path = pair.first;
-			Flow* const flow = pair.second;
-			if(flow == min_flow) {
-				if(path->GetEdgesSet().find(min_edge) != path->GetEdgesSet().end()) {
-					if(edge_flow_path_allocated[min_edge][min_flow][path] < -0.5) {
-						if(min_paths.empty() || 
-							(!min_paths.empty() && (min_paths.back()->GetEdges().size() == path->GetEdges().size()))) {
-							min_paths.push_back(path);
-						} else if(!min_paths.empty() && (min_paths.back()->GetEdges().size() < path->GetEdges().size())) {
-							longer_paths.push_back(path);
-						}
-					}
+		// The flow's progress counts once on every edge of each of its paths.
+		if(flow_rate > 0.0) {
+			for(Path* const path : flow->GetPaths()) {
+				for(const int edge_id : path->GetEdgeIDs()) {
+					edge_drain_[edge_id] += flow_rate;
 				}
 			}
 		}
-		// Split the fair share equally across all min-hop paths.
-		// cout << endl << "From here................ " << min_edge << " " << min_flow << " " << min_share << " " << min_paths.size() << endl;
-		for(Path* const min_path : min_paths) {
-			// cout << "Shortest Paths: ";
-			// PathsPrint(min_path);
-			assert(paths_map_[min_path] == min_flow);
-			assert(ordered_flow_paths_by_length.find(min_path) != ordered_flow_paths_by_length.end());
-			ordered_flow_paths_by_length.erase(min_path);			
-			const double path_share = min_share / min_paths.size();
-			for(Edge* const edge : min_path->GetEdges()) {
-				edge_flow_path_allocated[edge][min_flow][min_path] = path_share;
-			}
-		}
-		for(Path* const long_path : longer_paths) {
-			// cout << "Lonegr Paths: ";
-			// PathsPrint(long_path);
-			ordered_flow_paths_by_length.erase(long_path);
-			for(Edge* const edge : long_path->GetEdges()) {
-				edge_flow_path_allocated[edge][min_flow][long_path] = 0.0;
-			}
-		}
+		step_flows_.push_back(flow);
+		step_size_.push_back(flow->GetSize());
+		step_completed_.push_back(flow->GetCompleted());
+		step_rate_.push_back(flow_rate);
 	}
-	// Extract allocated rate per path from the detailed per edge allocations.
-	unordered_map<Path*, double> path_allocated_rate;
-	for(Edge* const edge : topo_->GetEdges()) {
-		for(auto& pair : edge_flow_path_allocated[edge]) {
-			Flow* const flow = pair.first;
-			for(auto& ppair : pair.second) {
-				Path* const path = ppair.first;
-				const double allocated = ppair.second;
-				if(allocated > 0) {
-					if(path_allocated_rate.find(path) != path_allocated_rate.end()) {
-						assert(path_allocated_rate[path] == allocated);
-						continue;
-					}
-					path_allocated_rate[path] = allocated;
-				}
+	// Verify link utilization is valid.
+	edge_utilization_.resize(csr.NumEdges());
+	for(int edge_id = 0; edge_id < csr.NumEdges(); edge_id++) {
+		const double capacity = csr.capacities[edge_id];
+		if(edge_load_[edge_id] >= capacity + 1E-6) {
+			cout << capacity << " -> " << edge_load_[edge_id] << endl;
+			for(Path* const path : edges_map_[topo_->GetEdges()[edge_id]]) {
+				PathsPrint(path);
 			}
 		}
+		assert(edge_load_[edge_id] < capacity + 1E-6);
+		assert(edge_load_[edge_id] > -1E-6);
+		edge_utilization_[edge_id] = (edge_load_[edge_id] / capacity);
 	}
-	// Now update the remaining bytes for all flows given the rates per path.
-	unordered_map<Edge*, double> utilization;
-	for(pair<Path* const, double> allocation : path_allocated_rate) {
-		for(Edge* const edge : allocation.first->GetEdges()) {
-			utilization[edge] += allocation.second;
+	return rates_;
+}
+
+// Transmit with the rates of the last ComputeRates for the given duration, then remove the
+// flows that completed by the current epoch.
+void FlowRouter::Transmit(double duration) {
+	ProgressSummary summary;
+	{
+		PhaseTimer timer(Phase::TRANSMISSION);
+		// Now update the remaining bytes for all flows given their rates.
+		summary = AdvanceFlows(step_completed_.data(), step_size_.data(), 
+			step_rate_.data(), step_flows_.size(), duration, rates_duration_);
+		flows_synced_ = step_flows_.empty();
+		rates_capped_ = summary.capped;
+		for(size_t edge_id = 0; edge_id < edge_drain_.size(); edge_id++) {
+			edge_remaining_demand_[edge_id] -= edge_drain_[edge_id] * duration;
 		}
-		Flow* const flow = paths_map_[allocation.first];
-		flow->AddCompleted(allocation.second * TIMESLOT_DURATION);
-		// cout << "From " << flow->GetID() << ", Completed: " << (allocation.second * TIMESLOT_DURATION) << endl;
 	}
-	// Verify link utilization is valid.
-	for(Edge* const edge : topo_->GetEdges()) {
-		if(utilization[edge] >= edge->GetCap() + 1E-6) {
-			cout << edge->GetCap() << " -> " << utilization[edge] << endl;
-			for(Path* const path : edges_map_[edge]) {
-				PathsPrint(path);
-			}
-		}
-		assert(utilization[edge] < edge->GetCap() + 1E-6);
-		assert(utilization[edge] > -1E-6);
-		edge_utilization_[edge] = (utilization[edge] / edge->GetCap());
+	if(summary.completed) {
+		RetireCompletedFlows();
 	}
+	// Verify consistency of data.
+	CheckConsistency();
+}
+
+void FlowRouter::RetireCompletedFlows() {
+	PhaseTimer timer(Phase::COMPLETION);
+	SyncFlows();
 	// Delete all completed flows.
 	vector<int> completed_flows;
 	for(pair<const int, Flow*>& flow_pair : flows_map_) {
 		Flow* const flow = flow_pair.second;
-		if(flow->GetRemainingSize() < 1E-6) {
+		if(flow->GetRemainingSize() < FLOW_COMPLETION_EPSILON) {
 			completed_flows.push_back(flow_pair.first);
-			flow_completion_times_[flow] = time_;
-			for(Path* const path : flow->GetPaths()) {
+			flow_completion_times_.Add(time_);
+			if(completion_callback_) {
+				completion_callback_(flow, time_);
+			}
+			const vector<Path*>& flow_paths = flow->GetPaths();
+			for(auto path_it = flow_paths.begin(); path_it != flow_paths.end(); path_it++) {
+				Path* const path = *path_it;
 				paths_map_.erase(path);
 				for(Edge* const edge : path->GetEdges()) {
 					auto& paths = edges_map_[edge];
 					auto it = find(paths.begin(), paths.end(), path);
 					assert(it != paths.end());
 					paths.erase(it);
+					const int edge_id = edge->GetID();
+					// The flow leaves the edge with the last of its paths on it.
+					if(!AnyPathContains(path_it + 1, flow_paths.end(), edge)) {
+						edge_active_flows_[edge_id]--;
+					}
+					// Reset idle edges so that rounding errors do not build up over the run. The edges
+					// were drained at the flow's full rate, so progress past its size is given back.
+					edge_remaining_demand_[edge_id] = paths.empty() ? 
+						0.0 : edge_remaining_demand_[edge_id] - (flow->GetSize() - flow->GetCompleted());
 				}
+				path_pool_.Recycle(path);
 			}
 		}
 	}
 	// Erase all completed flows.
 	for(int flow_id : completed_flows) {
+		flow_pool_.Recycle(flows_map_[flow_id]);
 		flows_map_.erase(flow_id);
 	}
-	// Verify consistency of data.
-	VerifyConsistency();
-	// Return the path rates.
-	return path_allocated_rate;
+	generation_++;
 }
 
-vector<double> FlowRouter::GetCompletionTimes() {
-	vector<double> flows;
-	for(auto& flow_pair : flow_completion_times_) {
-		flows.push_back(flow_pair.second);
+void FlowRouter::SyncFlows() {
+	if(flows_synced_) {
+		return;
 	}
-	return flows;
+	for(size_t index = 0; index < step_flows_.size(); index++) {
+		step_flows_[index]->SetCompleted(step_completed_[index]);
+	}
+	flows_synced_ = true;
+}
+
+const QuantileSketch& FlowRouter::GetCompletionTimes() const {
+	return flow_completion_times_;
 }
 
 int FlowRouter::getRemainingFlows() {
 	return flows_map_.size();
 }
 
+int FlowRouter::GetUnroutableFlows() const {
+	return unroutable_flows_;
+}
+
 void FlowRouter::VerifyConsistency() {
+	SyncFlows();
 	for(auto& pair : flows_map_) {
 		assert(pair.first == pair.second->GetID());
 	}
-	unordered_map<Path*, unordered_set<Edge*> > path_to_edges;
+	// Every (edge, path) entry must be an edge of a live path, without duplicates, and there
+	// must be as many entries as live paths have edges.
+	size_t entries = 0, path_edges = 0;
 	for(auto& pair : edges_map_) {
 		unordered_set<Path*> paths;
+		unordered_set<Flow*> flows;
 		for(auto path : pair.second) {
 			paths.insert(path);
-			path_to_edges[path].insert(pair.first);
-			assert(find(path->GetEdges().begin(), path->GetEdges().end(), pair.first) != path->GetEdges().end());
+			flows.insert(paths_map_[path]);
+			assert(paths_map_.find(path) != paths_map_.end());
+			assert(path->Contains(pair.first));
 		}
 		assert(paths.size() == pair.second.size());
+		entries += pair.second.size();
+		// The maintained aggregates match a fresh sum up to rounding.
+		double remaining_demand = 0.0;
+		for(auto path : pair.second) {
+			remaining_demand += paths_map_[path]->GetRemainingSize();
+		}
+		assert(GetEdgeActiveFlows(pair.first) == static_cast<int>(flows.size()));
+		assert(abs(GetEdgeRemainingDemand(pair.first) - remaining_demand) < 1E-6 * max(1.0, remaining_demand));
 	}
 	for(auto& pair : paths_map_) {
-		assert(pair.first->GetEdgesSet().size() == path_to_edges[pair.first].size());
-		for(auto edge : pair.first->GetEdgesSet()) {
-			assert(path_to_edges[pair.first].find(edge) != path_to_edges[pair.first].end());
-		}
-		for(auto edge : path_to_edges[pair.first]) {
-			assert(pair.first->GetEdgesSet().find(edge) != pair.first->GetEdgesSet().end());
-		}
+		path_edges += pair.first->GetEdgeIDs().size();
+	}
+	assert(entries == path_edges);
+}
+
+void FlowRouter::SetRateThreads(int threads) {
+	water_filling_.SetThreads(threads);
+}
+
+void FlowRouter::SetVerificationLevel(VerificationLevel level) {
+	verification_level_ = level;
+}
+
+void FlowRouter::CheckConsistency() {
+	const VerificationLevel level = min(verification_level_, MAX_VERIFICATION_LEVEL);
+	checkpoints_++;
+	if(level == VerificationLevel::FULL || 
+			(level == VerificationLevel::SAMPLED && checkpoints_ % VERIFICATION_SAMPLE_PERIOD == 0)) {
+		PhaseTimer timer(Phase::VERIFICATION);
+		VerifyConsistency();
 	}
 }
 
 double FlowRouter::GetTotalRemainingDemand() {
+	SyncFlows();
 	double total_vol = 0.0;
 	for(auto& pair : flows_map_) {
 		total_vol += pair.second->GetRemainingSize();
@@ -292,8 +370,23 @@ double FlowRouter::GetTotalRemainingDemand() {
 }
 
 double FlowRouter::GetEdgeUtilization(Edge* const edge) const {
-	return (edge_utilization_.find(edge) == edge_utilization_.end()) ?
-			0.0 : edge_utilization_.find(edge)->second;
+	return (static_cast<size_t>(edge->GetID()) < edge_utilization_.size()) ? edge_utilization_[edge->GetID()] : 0.0;
+}
+
+double FlowRouter::GetEdgeRemainingDemand(Edge* const edge) const {
+	return (static_cast<size_t>(edge->GetID()) < edge_remaining_demand_.size()) ? edge_remaining_demand_[edge->GetID()] : 0.0;
+}
+
+int FlowRouter::GetEdgeActiveFlows(Edge* const edge) const {
+	return (static_cast<size_t>(edge->GetID()) < edge_active_flows_.size()) ? edge_active_flows_[edge->GetID()] : 0;
+}
+
+void FlowRouter::SetCompletionCallback(function<void(Flow*, double)> callback) {
+	completion_callback_ = callback;
+}
+
+const Instrumentation& FlowRouter::GetInstrumentation() const {
+	return instrumentation_;
 }
 
 } // namespace Network
@@ -5,52 +5,159 @@
 #ifndef FLOW_ROUTER_HPP
 #define FLOW_ROUTER_HPP
 
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
+#include "instrumentation.hpp"
+#include "object_pool.hpp"
+#include "quantile_sketch.hpp"
 #include "tools.hpp"
+#include "water_filling.hpp"
 
 namespace Network {
 
 // Timeslot duration in seconds.
 constexpr double TIMESLOT_DURATION = 1;
 
+// How much of the router bookkeeping is cross-checked as the simulation runs.
+enum class VerificationLevel {
+  NONE,    // Never.
+  SAMPLED, // Once every VERIFICATION_SAMPLE_PERIOD checkpoints.
+  FULL,    // At every checkpoint (after each posted flow and each step).
+};
+
+// Checkpoints between two verifications at the SAMPLED level.
+constexpr int VERIFICATION_SAMPLE_PERIOD = 100;
+
+// Highest level compiled in, runtime levels above it are lowered to it. Set from CMake with
+// -DBWR_VERIFICATION=NONE|SAMPLED|FULL, otherwise it follows NDEBUG (the checks are asserts).
+#if defined(BWR_MAX_VERIFICATION)
+constexpr VerificationLevel MAX_VERIFICATION_LEVEL = VerificationLevel::BWR_MAX_VERIFICATION;
+#elif defined(NDEBUG)
+constexpr VerificationLevel MAX_VERIFICATION_LEVEL = VerificationLevel::NONE;
+#else
+constexpr VerificationLevel MAX_VERIFICATION_LEVEL = VerificationLevel::FULL;
+#endif
+
 // FlowRouter is an interface that all routers need to implement. It offers 
 // a unique set of access points to the flow routing functions shared by
 // all flow routing techniques.
 class FlowRouter {
 public:
-  FlowRouter(Topology* topo) : topo_(topo), time_(0.0) {}
-  ~FlowRouter();
-  // Implementted by the underlying routing policy.
-  virtual void PostFlow(Flow flow) = 0;
+  FlowRouter(Topology* topo) : topo_(topo), time_(0.0), water_filling_(topo), generation_(0),
+    rates_generation_(-1), rates_duration_(0.0), rates_capped_(false), flows_synced_(true),
+    verification_level_(VerificationLevel::FULL), checkpoints_(0), unroutable_flows_(0) {}
+  virtual ~FlowRouter();
+  // Admit a new flow and route it with the underlying routing policy.
+  void PostFlow(Flow flow);
+  // Admit flows that arrive together. They are routed one after the other in the given order,
+  // with the same paths as separate PostFlow calls, but the bookkeeping is checked once.
+  void PostFlows(const vector<Flow>& flows);
   // Compute the transmission rates according to the rate-allocation policy.
   // Assume data transmission with the computed rates for duration of one time unit.
   // Updated flow demands according to what was transmitted.
-  unordered_map<Path*, double> NextSlot();
-  // Extract flow completion times from this flow router object. Only flows completed to this
-  // point will be reported.
-  vector<double> GetCompletionTimes();
+  const unordered_map<Path*, double>& NextSlot();
+  // Event-driven alternative to NextSlot. Compute the rates (no per-timeslot demand cap) and
+  // advance the epoch to the earlier of next_arrival and the first flow completion under
+  // those rates, so completion times are exact rather than rounded up to timeslots. Without
+  // flows and with an infinite next_arrival the epoch stays where it is.
+  const unordered_map<Path*, double>& NextEvent(double next_arrival);
+  // Summary of the completion times of the flows completed so far, fed as they complete.
+  const QuantileSketch& GetCompletionTimes() const;
+  // Called with every flow as it completes, and the completion time, before it is recycled.
+  void SetCompletionCallback(function<void(Flow*, double)> callback);
   // Check whether there is any incomplete flows.
   int getRemainingFlows();
+  // Number of flows dropped on admission because their destination is unreachable.
+  int GetUnroutableFlows() const;
   // Obtain the simulation epoch.
   double getEpoch();
   // Verify consistency of stored data.
   void VerifyConsistency();
+  // Number of threads that compute the rates of each step (see WaterFilling::SetThreads).
+  void SetRateThreads(int threads);
+  // Set how often CheckConsistency verifies (capped by MAX_VERIFICATION_LEVEL).
+  void SetVerificationLevel(VerificationLevel level);
   // Get total remaining demand.
   double GetTotalRemainingDemand();
   // Get edge utilization.
   double GetEdgeUtilization(Edge* const edge) const;
+  // Sum over the paths on an edge of the remaining size of their flows (once per path), and
+  // the number of distinct flows with a path on the edge. Kept up to date as paths are
+  // installed, flows progress and complete.
+  double GetEdgeRemainingDemand(Edge* const edge) const;
+  int GetEdgeActiveFlows(Edge* const edge) const;
+  // Time per phase and hot-path counters of all calls to this router so far (all zero unless
+  // built with BWR_INSTRUMENTATION).
+  const Instrumentation& GetInstrumentation() const;
 protected:
+  // Implementted by the underlying routing policy: find and install the paths of a flow that
+  // was just added to flows_map_.
+  virtual void RouteFlow(Flow* new_flow) = 0;
+  // Add a copy of the flow to flows_map_ and route it, or drop it if it gets no path.
+  void AdmitFlow(const Flow& flow);
+  // Flows and paths live in pools owned by the router, completed ones are recycled.
+  Flow* NewFlow(const Flow& flow);
+  Path* NewPath(const Path& path);
+  // Add a path of a flow to the lookup tables and the per-edge aggregates. A path without
+  // edges (no path was found) is not added and NULL is returned, a flow left without paths
+  // is dropped by AdmitFlow.
+  Path* InstallPath(Flow* flow, const Path& path);
+  // Max-min fair rates of all paths for a step of the given duration. As long as no flow was
+  // admitted or completed, and no flow is capped by what it has left to send, the rates of
+  // the previous step still hold and are returned without recomputing them.
+  const unordered_map<Path*, double>& ComputeRates(double duration);
+  // Send traffic at the rates of the last ComputeRates for the given duration, then retire
+  // completed flows.
+  void Transmit(double duration);
+  // Remove the flows with nothing left to send from all the lookup tables and recycle them.
+  void RetireCompletedFlows();
+  // Copy the progress kept in step_completed_ back to the flows.
+  void SyncFlows();
+  // Checkpoint: run VerifyConsistency if the verification level asks for it.
+  void CheckConsistency();
   double time_; // The current timeslot.
   unordered_map<int, Flow*> flows_map_; // Flow id to flow pointer.
   unordered_map<Path*, Flow*> paths_map_; // Get the flow pointer associated with a path.
   unordered_map<Edge*, vector<Path*> > edges_map_; // Edge pointer to paths on that edge.
-  // The time at which a flow was completed. When it happens, this flow is removed from all the lookup tables above.
-  unordered_map<Flow*, double> flow_completion_times_;
+  // The times at which flows were completed. When it happens, the flow is removed from all the lookup
+  // tables above and its storage is recycled.
+  QuantileSketch flow_completion_times_;
   Topology* topo_; // The topology this router is associated with.
-  // Utilization data for routing purposes.
+  // Utilization data for routing purposes, indexed by edge id.
   // Max: 1.0, Min: 0.0
-  unordered_map<Edge*, double> edge_utilization_;
+  vector<double> edge_utilization_;
+  // Per-edge aggregates over the paths in edges_map_, indexed by edge id.
+  vector<double> edge_remaining_demand_;
+  vector<int> edge_active_flows_;
+  // Computes the max-min fair rates in NextSlot.
+  WaterFilling water_filling_;
+  ObjectPool<Flow> flow_pool_;
+  ObjectPool<Path> path_pool_;
+  // Bumped whenever a flow is admitted or completed.
+  long generation_;
+  // Rates of the last step, valid for rates_generation_ and rates_duration_.
+  unordered_map<Path*, double> rates_;
+  long rates_generation_;
+  double rates_duration_;
+  // Between two rate computations the flows progress in these arrays (see flow_progress.hpp)
+  // rather than in the Flow objects, one entry per flow of flows_map_ with its total rate.
+  vector<Flow*> step_flows_;
+  vector<double> step_size_;
+  vector<double> step_completed_;
+  vector<double> step_rate_;
+  // Per edge, the total rate of the paths on it and the rate at which its remaining demand
+  // drains (the total rate of every flow counts once for each of its paths on the edge).
+  vector<double> edge_load_;
+  vector<double> edge_drain_;
+  bool rates_capped_; // Some flow has less left than its rate sends in a step of rates_duration_.
+  bool flows_synced_; // The flows hold the progress in step_completed_.
+  VerificationLevel verification_level_;
+  long checkpoints_; // Number of CheckConsistency calls so far.
+  int unroutable_flows_;
+  Instrumentation instrumentation_;
+  function<void(Flow*, double)> completion_callback_;
 };
 
 } // namespace Network
@@ -0,0 +1,116 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef INDEXED_HEAP_HPP
+#define INDEXED_HEAP_HPP
+
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+namespace Network {
+
+// Min-heap over the integers [0, n) with a key per item and support for decrease-key.
+// D is the arity of the heap. The storage is kept when the heap is emptied so a single
+// object can be reused across many searches without reallocating.
+template<int D = 4>
+class IndexedHeap {
+public:
+  // Make room for items [0, n). Must be called while the heap is empty.
+  void Resize(int n) {
+    assert(heap_.empty());
+    if(position_.size() < n) {
+      position_.resize(n, -1);
+      keys_.resize(n);
+    }
+  }
+  bool Empty() const {
+    return heap_.empty();
+  }
+  bool Contains(int item) const {
+    return position_[item] >= 0;
+  }
+  double Key(int item) const {
+    return keys_[item];
+  }
+  // Insert the item or lower its key (the key must not increase).
+  void PushOrDecrease(int item, double key) {
+    if(position_[item] < 0) {
+      position_[item] = heap_.size();
+      heap_.push_back(item);
+    } else {
+      assert(key <= keys_[item]);
+    }
+    keys_[item] = key;
+    SiftUp(position_[item]);
+  }
+  // Remove and return the item with the smallest key.
+  int PopMin() {
+    assert(!heap_.empty());
+    const int top = heap_[0];
+    position_[top] = -1;
+    const int last = heap_.back();
+    heap_.pop_back();
+    if(!heap_.empty()) {
+      heap_[0] = last;
+      position_[last] = 0;
+      SiftDown(0);
+    }
+    return top;
+  }
+  // Remove all items, in time proportional to the number of items left.
+  void Clear() {
+    for(const int item : heap_) {
+      position_[item] = -1;
+    }
+    heap_.clear();
+  }
+private:
+  void SiftUp(int index) {
+    const int item = heap_[index];
+    while(index > 0) {
+      const int parent = (index - 1) / D;
+      if(!(keys_[item] < keys_[heap_[parent]])) {
+        break;
+      }
+      heap_[index] = heap_[parent];
+      position_[heap_[index]] = index;
+      index = parent;
+    }
+    heap_[index] = item;
+    position_[item] = index;
+  }
+  void SiftDown(int index) {
+    const int item = heap_[index];
+    const int size = heap_.size();
+    for(;;) {
+      const int first = index * D + 1;
+      if(first >= size) {
+        break;
+      }
+      int best = first;
+      for(int child = first + 1; child < first + D && child < size; child++) {
+        if(keys_[heap_[child]] < keys_[heap_[best]]) {
+          best = child;
+        }
+      }
+      if(!(keys_[heap_[best]] < keys_[item])) {
+        break;
+      }
+      heap_[index] = heap_[best];
+      position_[heap_[index]] = index;
+      index = best;
+    }
+    heap_[index] = item;
+    position_[item] = index;
+  }
+  vector<int> heap_;     // Items in heap order.
+  vector<int> position_; // Index of every item in heap_, -1 if not in the heap.
+  vector<double> keys_;
+};
+
+} // namespace Network
+
+#endif // INDEXED_HEAP_HPP
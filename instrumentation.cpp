@@ -0,0 +1,71 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <cassert>
+
+#include "instrumentation.hpp"
+
+namespace Network {
+
+Instrumentation& Instrumentation::operator+=(const Instrumentation& other) {
+  for(int phase = 0; phase < NUM_PHASES; phase++) {
+    seconds[phase] += other.seconds[phase];
+  }
+  for(int counter = 0; counter < NUM_COUNTERS; counter++) {
+    counts[counter] += other.counts[counter];
+  }
+  return *this;
+}
+
+Instrumentation& Instrumentation::operator-=(const Instrumentation& other) {
+  for(int phase = 0; phase < NUM_PHASES; phase++) {
+    seconds[phase] -= other.seconds[phase];
+  }
+  for(int counter = 0; counter < NUM_COUNTERS; counter++) {
+    counts[counter] -= other.counts[counter];
+  }
+  return *this;
+}
+
+string PhaseName(Phase phase) {
+  switch(phase) {
+    case Phase::ROUTING:
+      return "routing_s";
+    case Phase::RATE_ALLOCATION:
+      return "rate_allocation_s";
+    case Phase::TRANSMISSION:
+      return "transmission_s";
+    case Phase::COMPLETION:
+      return "completion_s";
+    case Phase::VERIFICATION:
+      return "verification_s";
+    default:
+      assert(false);
+  }
+  return "";
+}
+
+string CounterName(Counter counter) {
+  switch(counter) {
+    case Counter::FLOWS_FROZEN:
+      return "flows_frozen";
+    case Counter::RATE_RECOMPUTES:
+      return "rate_recomputes";
+    case Counter::RATE_REUSES:
+      return "rate_reuses";
+    case Counter::HEAP_PUSHES:
+      return "heap_pushes";
+    case Counter::HEAP_POPS:
+      return "heap_pops";
+    case Counter::FLOW_ALLOCATIONS:
+      return "flow_allocations";
+    case Counter::PATH_ALLOCATIONS:
+      return "path_allocations";
+    default:
+      assert(false);
+  }
+  return "";
+}
+
+} // namespace Network
@@ -0,0 +1,132 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+namespace Network {
+
+// Where the time of a router goes. The phases do not overlap.
+enum class Phase {
+  ROUTING,         // Finding and installing the paths of admitted flows.
+  RATE_ALLOCATION, // Recomputing the max-min fair rates.
+  TRANSMISSION,    // Advancing the flows by one step.
+  COMPLETION,      // Retiring completed flows.
+  VERIFICATION,    // VerifyConsistency.
+  NUM_PHASES,
+};
+
+// Events counted on the hot paths.
+enum class Counter {
+  FLOWS_FROZEN,     // Flows frozen by the progressive filling loop.
+  RATE_RECOMPUTES,  // Steps that recomputed the rates.
+  RATE_REUSES,      // Steps that reused the rates of the previous step.
+  HEAP_PUSHES,      // Heap pushes of the path searches.
+  HEAP_POPS,        // Heap pops of the path searches.
+  FLOW_ALLOCATIONS, // Flows taken from the router's pool.
+  PATH_ALLOCATIONS, // Paths taken from the router's pool.
+  NUM_COUNTERS,
+};
+
+constexpr int NUM_PHASES = static_cast<int>(Phase::NUM_PHASES);
+constexpr int NUM_COUNTERS = static_cast<int>(Counter::NUM_COUNTERS);
+
+// Compiled in with -DBWR_INSTRUMENTATION=ON in CMake. Otherwise every hook below is empty
+// and the totals stay zero.
+#if defined(BWR_INSTRUMENTATION)
+constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+// Cumulative time per phase and totals per counter.
+struct Instrumentation {
+  double seconds[NUM_PHASES] = {};
+  uint64_t counts[NUM_COUNTERS] = {};
+  double Seconds(Phase phase) const {
+    return seconds[static_cast<int>(phase)];
+  }
+  uint64_t Count(Counter counter) const {
+    return counts[static_cast<int>(counter)];
+  }
+  Instrumentation& operator+=(const Instrumentation& other);
+  Instrumentation& operator-=(const Instrumentation& other);
+};
+
+// Column names, as used in the instrumentation log (e.g. "routing_s", "heap_pushes").
+string PhaseName(Phase phase);
+string CounterName(Counter counter);
+
+// Totals of the calling thread. Hooks add to it, FlowRouter attributes them to the router
+// that was called (see InstrumentationScope).
+inline Instrumentation& ThreadInstrumentation() {
+  static thread_local Instrumentation instrumentation;
+  return instrumentation;
+}
+
+#if defined(BWR_INSTRUMENTATION)
+inline void Count(Instrumentation& target, Counter counter, uint64_t count = 1) {
+  target.counts[static_cast<int>(counter)] += count;
+}
+
+inline void Count(Counter counter, uint64_t count = 1) {
+  Count(ThreadInstrumentation(), counter, count);
+}
+
+// Add the totals of a scratch object that other threads counted into to the calling thread
+// and reset it.
+inline void Collect(Instrumentation& scratch) {
+  ThreadInstrumentation() += scratch;
+  scratch = Instrumentation();
+}
+#else
+inline void Count(Instrumentation&, Counter, uint64_t = 1) {}
+inline void Count(Counter, uint64_t = 1) {}
+inline void Collect(Instrumentation&) {}
+#endif
+
+// Adds the time until it goes out of scope to a phase of the calling thread.
+class PhaseTimer {
+public:
+#if defined(BWR_INSTRUMENTATION)
+  explicit PhaseTimer(Phase phase) : phase_(phase), start_(chrono::steady_clock::now()) {}
+  ~PhaseTimer() {
+    ThreadInstrumentation().seconds[static_cast<int>(phase_)] +=
+      chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+  }
+private:
+  const Phase phase_;
+  const chrono::steady_clock::time_point start_;
+#else
+  explicit PhaseTimer(Phase) {}
+#endif
+};
+
+// Adds what the calling thread counted until it goes out of scope to the given totals.
+class InstrumentationScope {
+public:
+#if defined(BWR_INSTRUMENTATION)
+  explicit InstrumentationScope(Instrumentation& target) : target_(target), start_(ThreadInstrumentation()) {}
+  ~InstrumentationScope() {
+    Instrumentation delta = ThreadInstrumentation();
+    delta -= start_;
+    target_ += delta;
+  }
+private:
+  Instrumentation& target_;
+  const Instrumentation start_;
+#else
+  explicit InstrumentationScope(Instrumentation&) {}
+#endif
+};
+
+} // namespace Network
+
+#endif // INSTRUMENTATION_HPP
@@ -37,12 +37,14 @@ vector<RouterFactory::RouterType> ListRouters() {
 	    RouterFactory::RouterType::SHORTEST_PATH_ROUTER_BY_HOPS,
 	    RouterFactory::RouterType::SHORTEST_PATH_ROUTER_BY_INVERSE_CAPACITY,
 	    RouterFactory::RouterType::UTILIZATION_ROUTER,
+	    RouterFactory::RouterType::BWR_ROUTER_BWRHF_K,
+	    RouterFactory::RouterType::BWR_ROUTER_BWRHF_K_PRUNE,
 	};
 }
 
 vector<Scenario> BuildScenarios() {
 	return {
-		// Each row is: {double lambda_, double mu_, Stochastic::DistributionTypes dist_type_, double sim_duration_, Topology* topo_}
+		// Each row is: {double lambda_, double mu_, Stochastic::DistributionTypes dist_type_, double sim_duration_, Topology* topo_[, SimulationMode mode_, uint64_t seed_, uint64_t stream_, string trace_, VerificationLevel verification_, bool flow_records_]}
 		// {1, 1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 500.0, BuildTopologyGSCALE()},
 		{0.2, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 1000.0, BuildTopologyUNINETT2011()},
 	};
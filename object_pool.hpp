@@ -0,0 +1,69 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+namespace Network {
+
+// Slab storage for objects of type T with stable addresses. Objects are carved out of
+// chunks of CHUNK objects. A recycled object stays constructed and is overwritten by
+// copy assignment when it is handed out again, so any buffers it owns (e.g. vectors) are
+// reused rather than freed and reallocated. All objects are destroyed with the pool.
+template<typename T, int CHUNK = 256>
+class ObjectPool {
+public:
+  ObjectPool() : constructed_(0) {}
+  ~ObjectPool() {
+    for(int index = 0; index < constructed_; index++) {
+      Slot(index)->~T();
+    }
+  }
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+  // Return an object equal to value, recycled if possible.
+  T* New(const T& value) {
+    if(!free_.empty()) {
+      T* const object = free_.back();
+      free_.pop_back();
+      *object = value;
+      return object;
+    }
+    if(constructed_ == static_cast<int>(chunks_.size()) * CHUNK) {
+      chunks_.emplace_back(new Storage[CHUNK]);
+    }
+    T* const object = Slot(constructed_);
+    new (object) T(value);
+    constructed_++;
+    return object;
+  }
+  // Give back an object obtained from New, it must not be used afterwards.
+  void Recycle(T* object) {
+    free_.push_back(object);
+  }
+  // Number of objects handed out and not recycled.
+  int Size() const {
+    return constructed_ - free_.size();
+  }
+private:
+  using Storage = typename aligned_storage<sizeof(T), alignof(T)>::type;
+  T* Slot(int index) {
+    return reinterpret_cast<T*>(&chunks_[index / CHUNK][index % CHUNK]);
+  }
+  vector<unique_ptr<Storage[]>> chunks_;
+  int constructed_; // Slots [0, constructed_) hold constructed objects.
+  vector<T*> free_; // Recycled objects.
+};
+
+} // namespace Network
+
+#endif // OBJECT_POOL_HPP
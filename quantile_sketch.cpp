@@ -0,0 +1,166 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "quantile_sketch.hpp"
+
+namespace Network {
+
+namespace {
+
+// Ratio between the bounds of a bucket, the middle of a bucket is within the relative
+// accuracy of everything in it.
+const double SKETCH_GAMMA = (1.0 + SKETCH_RELATIVE_ACCURACY) / (1.0 - SKETCH_RELATIVE_ACCURACY);
+const double SKETCH_LOG_GAMMA = log(SKETCH_GAMMA);
+
+}
+
+QuantileSketch::QuantileSketch() : count_(0), min_(numeric_limits<double>::infinity()),
+  max_(-numeric_limits<double>::infinity()), mean_(0.0), m2_(0.0), compressed_(false),
+  bucket_offset_(0), zeros_(0) {}
+
+void QuantileSketch::Add(double value) {
+  assert(value >= 0.0);
+  count_++;
+  min_ = min(min_, value);
+  max_ = max(max_, value);
+  const double delta = value - mean_;
+  mean_ += delta / count_;
+  m2_ += delta * (value - mean_);
+  if(!compressed_) {
+    // Completion times mostly come in order, so this is usually an append.
+    exact_.insert(upper_bound(exact_.begin(), exact_.end(), value), value);
+    if(exact_.size() > SKETCH_EXACT_SAMPLES) {
+      Compress();
+    }
+  } else {
+    AddToBuckets(value);
+  }
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  if(other.count_ == 0) {
+    return;
+  }
+  // Combine the moments (Chan et al.).
+  const uint64_t count = count_ + other.count_;
+  const double delta = other.mean_ - mean_;
+  mean_ += delta * other.count_ / count;
+  m2_ += other.m2_ + delta * delta * count_ * other.count_ / count;
+  count_ = count;
+  min_ = min(min_, other.min_);
+  max_ = max(max_, other.max_);
+  if(!compressed_ && !other.compressed_ && exact_.size() + other.exact_.size() <= SKETCH_EXACT_SAMPLES) {
+    const size_t middle = exact_.size();
+    exact_.insert(exact_.end(), other.exact_.begin(), other.exact_.end());
+    inplace_merge(exact_.begin(), exact_.begin() + middle, exact_.end());
+    return;
+  }
+  Compress();
+  if(!other.compressed_) {
+    for(const double value : other.exact_) {
+      AddToBuckets(value);
+    }
+    return;
+  }
+  zeros_ += other.zeros_;
+  for(int index = 0; index < static_cast<int>(other.buckets_.size()); index++) {
+    if(other.buckets_[index] > 0) {
+      AddToBucket(other.bucket_offset_ + index, other.buckets_[index]);
+    }
+  }
+}
+
+uint64_t QuantileSketch::Count() const {
+  return count_;
+}
+
+double QuantileSketch::Min() const {
+  return min_;
+}
+
+double QuantileSketch::Max() const {
+  return max_;
+}
+
+double QuantileSketch::Mean() const {
+  return mean_;
+}
+
+double QuantileSketch::Variance() const {
+  return (count_ > 0) ? m2_ / count_ : 0.0;
+}
+
+double QuantileSketch::Quantile(double fraction) const {
+  assert(count_ > 0 && fraction >= 0.0 && fraction <= 1.0);
+  const uint64_t rank = min(static_cast<uint64_t>(count_ * fraction), count_ - 1);
+  if(!compressed_) {
+    return exact_[rank];
+  }
+  // The extremes are known exactly.
+  if(rank == count_ - 1) {
+    return max_;
+  }
+  uint64_t seen = zeros_;
+  if(rank < seen) {
+    return min_;
+  }
+  for(int index = 0; index < static_cast<int>(buckets_.size()); index++) {
+    seen += buckets_[index];
+    if(rank < seen) {
+      return min(max(BucketValue(bucket_offset_ + index), min_), max_);
+    }
+  }
+  assert(false);
+  return max_;
+}
+
+void QuantileSketch::Compress() {
+  if(compressed_) {
+    return;
+  }
+  compressed_ = true;
+  for(const double value : exact_) {
+    AddToBuckets(value);
+  }
+  // Release the storage, the sketch stays compressed from now on.
+  vector<double>().swap(exact_);
+}
+
+void QuantileSketch::AddToBuckets(double value) {
+  if(value < SKETCH_MIN_VALUE) {
+    zeros_++;
+  } else {
+    AddToBucket(BucketIndex(value), 1);
+  }
+}
+
+int QuantileSketch::BucketIndex(double value) const {
+  return static_cast<int>(ceil(log(value) / SKETCH_LOG_GAMMA));
+}
+
+double QuantileSketch::BucketValue(int index) const {
+  return 2.0 * pow(SKETCH_GAMMA, index) / (SKETCH_GAMMA + 1.0);
+}
+
+void QuantileSketch::AddToBucket(int index, uint64_t count) {
+  if(buckets_.empty()) {
+    bucket_offset_ = index;
+  } else if(index < bucket_offset_) {
+    buckets_.insert(buckets_.begin(), bucket_offset_ - index, 0);
+    bucket_offset_ = index;
+  }
+  // Not negative after the adjustment above.
+  const size_t slot = index - bucket_offset_;
+  if(slot >= buckets_.size()) {
+    buckets_.resize(slot + 1, 0);
+  }
+  buckets_[slot] += count;
+}
+
+} // namespace Network
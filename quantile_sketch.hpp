@@ -0,0 +1,63 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef QUANTILE_SKETCH_HPP
+#define QUANTILE_SKETCH_HPP
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace Network {
+
+// Relative error of the quantiles once a sketch holds more than SKETCH_EXACT_SAMPLES values.
+constexpr double SKETCH_RELATIVE_ACCURACY = 1E-3;
+// Up to this many values are kept as they are and the quantiles are exact.
+constexpr int SKETCH_EXACT_SAMPLES = 1 << 16;
+// Non-negative values below this one are counted as zero.
+constexpr double SKETCH_MIN_VALUE = 1E-9;
+
+// Streaming summary of non-negative values (e.g. flow completion times) in constant memory:
+// count, min, max, mean and variance are tracked exactly, quantiles come from a histogram
+// with logarithmic buckets (as in HDR histograms and DDSketch), so every reported quantile
+// is within SKETCH_RELATIVE_ACCURACY of a value at that rank. Small samples are kept exactly
+// instead. Sketches merge without loss, e.g. across parallel or replicated runs. The const
+// members never write, so any number of threads can read a sketch at once.
+class QuantileSketch {
+public:
+  QuantileSketch();
+  void Add(double value);
+  void Merge(const QuantileSketch& other);
+  uint64_t Count() const;
+  double Min() const;
+  double Max() const;
+  double Mean() const;
+  double Variance() const;
+  // The value at rank floor(Count() * fraction) of the sorted values (clamped to the last
+  // one), fraction is in [0, 1]. The sketch must not be empty.
+  double Quantile(double fraction) const;
+private:
+  // Move the exact values into the buckets.
+  void Compress();
+  // Count a value in the buckets (or as zero).
+  void AddToBuckets(double value);
+  int BucketIndex(double value) const;
+  double BucketValue(int index) const;
+  void AddToBucket(int index, uint64_t count);
+
+  uint64_t count_;
+  double min_, max_;
+  double mean_, m2_; // Running mean and sum of squared deviations (Welford).
+  bool compressed_;
+  vector<double> exact_; // Values while not compressed, kept sorted.
+  // Bucket i (offset by bucket_offset_) holds values in (gamma^(i-1), gamma^i].
+  vector<uint64_t> buckets_;
+  int bucket_offset_;
+  uint64_t zeros_; // Values below SKETCH_MIN_VALUE.
+};
+
+} // namespace Network
+
+#endif // QUANTILE_SKETCH_HPP
@@ -0,0 +1,61 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <cassert>
+
+#include "route_table.hpp"
+#include "thread_pool.hpp"
+
+namespace Network {
+
+RouteTable::RouteTable(Topology* topo, RouteMetric metric) : topo_(topo), metric_(metric),
+  trees_(topo->GetCSR().NumNodes()), built_(new once_flag[topo->GetCSR().NumNodes()]) {}
+
+Path RouteTable::GetPath(int src, int dst, int flow_id) {
+  const vector<int>& tree = Tree(src);
+  const vector<Edge*>& edges = topo_->GetEdges();
+  const CSRGraph& csr = topo_->GetCSR();
+  Path path(flow_id);
+  if(tree[dst] < 0) {
+    return path;
+  }
+  static thread_local vector<int> reversed_path;
+  reversed_path.clear();
+  for(int node = dst; node != src; node = csr.edge_src[tree[node]]) {
+    reversed_path.push_back(tree[node]);
+  }
+  for(auto it = reversed_path.rbegin(); it != reversed_path.rend(); it++) {
+    path.AddEdge(edges[*it]);
+  }
+  return path;
+}
+
+void RouteTable::Precompute(int threads) {
+  ThreadPool pool(threads);
+  pool.ParallelFor(trees_.size(), [this](int src) {
+    Tree(src);
+  });
+}
+
+const vector<int>& RouteTable::Tree(int src) {
+  // The once flag also publishes the tree to every thread that looks it up afterwards.
+  call_once(built_[src], &RouteTable::BuildTree, this, src);
+  return trees_[src];
+}
+
+void RouteTable::BuildTree(int src) {
+  static thread_local DijkstraSearch search;
+  auto cost_func = [this](Edge* edge) {
+    switch(metric_) {
+      case RouteMetric::HOPS: return 1.0;
+      case RouteMetric::INVERSE_CAPACITY: return 1.0 / edge->GetCap();
+      default:
+        assert(false);
+    }
+    return 0.0;
+  };
+  search.FindTree(topo_, src, cost_func, trees_[src]);
+}
+
+} // namespace Network
@@ -0,0 +1,48 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef ROUTE_TABLE_HPP
+#define ROUTE_TABLE_HPP
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tools.hpp"
+#include "topology.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Edge costs that only depend on the topology.
+enum class RouteMetric : int {
+  HOPS,             // 1 per edge.
+  INVERSE_CAPACITY, // 1 / capacity per edge.
+};
+
+// Shortest paths between all pairs of nodes of a topology under a static edge cost, get one
+// with Topology::GetRouteTable to share it with every router on the topology. The shortest
+// path tree of a source (one search covers all of its destinations) is built the first time
+// the source is looked up, or up front with Precompute, and takes one int per node. Paths
+// are the ones DijkstraSearch::FindPath gives. Safe to use from several threads.
+class RouteTable {
+public:
+  RouteTable(Topology* topo, RouteMetric metric);
+  // Shortest path from src to dst for the flow with the given id, empty if dst is unreachable.
+  Path GetPath(int src, int dst, int flow_id);
+  // Build the trees of all sources, over the given number of threads (see ThreadPool).
+  void Precompute(int threads);
+private:
+  const vector<int>& Tree(int src);
+  void BuildTree(int src);
+  Topology* const topo_;
+  const RouteMetric metric_;
+  vector<vector<int> > trees_; // Source to predecessor edge of every node (see FindTree).
+  unique_ptr<once_flag[]> built_;
+};
+
+} // namespace Network
+
+#endif // ROUTE_TABLE_HPP
@@ -28,13 +28,18 @@ public:
     SHORTEST_PATH_ROUTER_BY_HOPS,
     SHORTEST_PATH_ROUTER_BY_INVERSE_CAPACITY,
     UTILIZATION_ROUTER,
+    BWR_ROUTER_BWRHF_K,
+    BWR_ROUTER_BWRHF_K_PRUNE,
   };
 
   static FlowRouter* BuildRouter(RouterType router_type, Topology* topo) {
     switch(router_type) {
-      case RouterType::BWR_ROUTER_BWROPT:
-        return new BWRRouter(topo, BWRRouter::TECHNIQUE::BWROPT);
+      case RouterType::BWR_ROUTER_BWROPT: {
+        BWRRouter* router = new BWRRouter(topo, BWRRouter::TECHNIQUE::BWROPT);
+        router->SetSearchBudget(BWR_OPT_MAX_EXPANSIONS, 0);
+        return router;
         break;
+      }
       case RouterType::BWR_ROUTER_BWRHF:
         return new BWRRouter(topo, BWRRouter::TECHNIQUE::BWRHF);
         break;
@@ -47,6 +52,12 @@ public:
       case RouterType::UTILIZATION_ROUTER:
         return new UtilizationRouter(topo);
         break;
+      case RouterType::BWR_ROUTER_BWRHF_K:
+        return new BWRRouter(topo, BWRRouter::TECHNIQUE::BWRHF_K);
+        break;
+      case RouterType::BWR_ROUTER_BWRHF_K_PRUNE:
+        return new BWRRouter(topo, BWRRouter::TECHNIQUE::BWRHF_K_PRUNE);
+        break;
       default:
         assert(false);
     }
@@ -20,16 +20,19 @@ using namespace std;
 namespace Network {
 
 void ShortestPathRouter::ComputeShortestPath(Flow* new_flow, const TECHNIQUE tech) {
+  // The static costs only depend on the topology, their paths come from its route table.
+  if(tech_ == TECHNIQUE::BY_HOPS || tech_ == TECHNIQUE::BY_INVERSE_CAPACITY) {
+    if(routes_ == NULL) {
+      routes_ = &topo_->GetRouteTable((tech_ == TECHNIQUE::BY_HOPS) ? RouteMetric::HOPS : RouteMetric::INVERSE_CAPACITY);
+    }
+    InstallPath(new_flow, routes_->GetPath(new_flow->GetSrc()->GetID(), new_flow->GetDst()->GetID(), new_flow->GetID()));
+    return;
+  }
   // Wrapper around the generic shortest path callback.
-  function<double(Edge*)> cost_func = [&](Edge* edge) {
+  auto cost_func = [&](Edge* edge) {
     return getEdgeCost(edge, tech);
   };
-  Path* new_path = new Path(ComputeShortestPathGeneric(topo_, new_flow, cost_func));
-  new_flow->AddPath(new_path);
-  paths_map_[new_path] = new_flow;
-  for(Edge* const edge : new_path->GetEdges()) {
-    edges_map_[edge].push_back(new_path);
-  }
+  InstallPath(new_flow, ComputeShortestPathGeneric(topo_, new_flow, cost_func));
 }
 
 double ShortestPathRouter::getEdgeCost(Edge* const edge, const TECHNIQUE tech) {
@@ -48,16 +51,9 @@ double ShortestPathRouter::getEdgeCost(Edge* const edge) {
   return 0;
 }
 
-void ShortestPathRouter::PostFlow(Flow flow) {
-  // cout << "PostFlow()" << endl;
-
-  assert(flow.GetSrc() != flow.GetDst());
-  Flow* new_flow = new Flow(flow);
-  flows_map_[new_flow->GetID()] = new_flow;
-
+void ShortestPathRouter::RouteFlow(Flow* new_flow) {
+  // cout << "RouteFlow()" << endl;
   ComputeShortestPath(new_flow, tech_);
-
-  VerifyConsistency();
 }
 
 } // namespace Network
\ No newline at end of file
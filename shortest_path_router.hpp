@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "flow_router.hpp"
+#include "route_table.hpp"
 #include "tools.hpp"
 #include "topology.hpp"
 
@@ -21,10 +22,12 @@ public:
     BY_HOPS, BY_INVERSE_CAPACITY, VIRTUAL_FUNCTION_CALL
   };
   ShortestPathRouter(Topology* topo, TECHNIQUE tech) : 
-            FlowRouter(topo), tech_(tech) {}
-  void PostFlow(Flow flow);
+            FlowRouter(topo), tech_(tech), routes_(NULL) {}
 protected:
+  void RouteFlow(Flow* new_flow) override;
   TECHNIQUE tech_;
+  // Route table of the topology for BY_HOPS and BY_INVERSE_CAPACITY, set on first use.
+  RouteTable* routes_;
   void ComputeShortestPath(Flow* new_flow, const TECHNIQUE tech);
   double getEdgeCost(Edge* const edge, const TECHNIQUE tech);
   virtual double getEdgeCost(Edge* const edge);
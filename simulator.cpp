@@ -5,18 +5,24 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <sstream>
 
+#include "flow_records.hpp"
 #include "simulator.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 using namespace std;
 
 namespace Network {
 
+// Report every percentile of the completion times rather than the max, p99 and p95.
 constexpr bool REPORT_ALL_PERCENTILES = false;
 
-Logger::Logger(string filename) : filename_(filename), file_(fopen(filename.c_str(), "w")) {
+Logger::Logger(string filename) : filename_(filename), file_(fopen(filename.c_str(), "w")), next_row_(0) {
 	assert(file_ != NULL);
 	string data = "stats = [\r\n";
 	fputs(data.c_str(), file_);
@@ -27,10 +33,9 @@ Logger::~Logger() {
 	Close();
 }
 
-void Logger::Log(const Scenario& scenario, const int router_id, vector<double> completion_times) {
+void Logger::Log(int row, const Scenario& scenario, const int router_id, const QuantileSketch& completion_times) {
 	// Write a row in the output matrix log file.
-	assert(!completion_times.empty());
-	sort(completion_times.begin(), completion_times.end());
+	assert(completion_times.Count() > 0);
 	stringstream ss;
 	ss << 
 		scenario.lambda << ", " << 
@@ -40,26 +45,28 @@ void Logger::Log(const Scenario& scenario, const int router_id, vector<double> c
 		hash<string>()(scenario.topo->GetName()) << ", " <<
 		router_id << ", ";
 	if(REPORT_ALL_PERCENTILES) {
-		for(double completion_time : completion_times) {
-			ss << completion_time << ", ";
+		for(int percentile = 1; percentile <= 100; percentile++) {
+			ss << completion_times.Quantile(percentile / 100.0) << ", ";
 		}
 	} else {
-		ss << completion_times.back() << ", ";
-		ss << completion_times[static_cast<int>(completion_times.size() * 0.99)] << ", ";
-		ss << completion_times[static_cast<int>(completion_times.size() * 0.95)] << ", ";
+		ss << completion_times.Max() << ", ";
+		ss << completion_times.Quantile(0.99) << ", ";
+		ss << completion_times.Quantile(0.95) << ", ";
 	}
-	ss << completion_times[static_cast<int>(completion_times.size() * 0.5)] << ", ";
-	double avg_completion_times = 0.0;
-	for(double completion_time : completion_times) {
-		avg_completion_times += completion_time / completion_times.size();
+	ss << completion_times.Quantile(0.5) << ", ";
+	ss << completion_times.Mean() << ";";
+	lock_guard<mutex> lock(mutex_);
+	pending_rows_[row] = ss.str() + "\r\n";
+	// Write out every row that is no longer waiting for an earlier one.
+	for(auto it = pending_rows_.begin(); it != pending_rows_.end() && it->first == next_row_; it = pending_rows_.erase(it)) {
+		const string& data = it->second;
+		cout << "Logging " << data.size() << " bytes into " << filename_ << endl << endl;
+		int error = fputs(data.c_str(), file_);
+		assert(error >= 0);
+		error = fflush(file_);
+		assert(error == 0);
+		next_row_++;
 	}
-	ss << avg_completion_times << ";";
-	string data = ss.str() + "\r\n";
-	cout << "Logging " << data.size() << " bytes into " << filename_ << endl << endl;
-	int error = fputs(data.c_str(), file_);
-	assert(error >= 0);
-	error = fflush(file_);
-	assert(error == 0);
 }
 
 void Logger::Close() {
@@ -75,60 +82,203 @@ long GenerateTimestamp() {
     return chrono::duration_cast<chrono::milliseconds>(epoch).count();
 }
 
-vector<tuple<double, double, int, int>> GenerateTraffic(Scenario& scenario) {
-	vector<tuple<double, double, int, int>> traffic;
-	Stochastic dist(scenario.lambda, scenario.mu, scenario.dist_type);
-	pair<double, double> flow;
-	int nodes = scenario.topo->GetNodes().size();
-	vector<pair<int, int>> src_dst_pairs;
-	for(int src = 0; src < nodes; src++) {
-		for(int dst = src+1; dst < nodes; dst++) {
-			src_dst_pairs.push_back(make_pair(src, dst));
-		}
+StochasticTrafficSource::StochasticTrafficSource(const Scenario& scenario) : 
+	dist_(scenario.lambda, scenario.mu, scenario.dist_type, scenario.seed, scenario.stream),
+	sim_duration_(scenario.sim_duration), nodes_(scenario.topo->GetNodes().size()),
+	num_pairs_(static_cast<long long>(nodes_) * (nodes_ - 1) / 2) {
+	Sample();
+}
+
+void StochasticTrafficSource::Sample() {
+	const pair<double, double> flow = dist_.nextSample();
+	next_.arrival = flow.first;
+	next_.volume = flow.second;
+	if(!HasNext()) {
+		return;
+	}
+	// Every 100th pair in the order (0, 1), (0, 2), ..., (1, 2), ... is used. Find the row
+	// of the picked pair instead of listing all pairs. Topologies with fewer than 100 pairs
+	// only use the first one.
+	long long pair_index = dist_.genIndex(max(1LL, num_pairs_ / 100)) * 100;
+	int src = 0;
+	while(pair_index >= nodes_ - 1 - src) {
+		pair_index -= nodes_ - 1 - src;
+		src++;
 	}
-	srand(GenerateTimestamp());
-	while((flow = dist.nextSample()).first < scenario.sim_duration) {
-		int src_dst_index = (rand() % (src_dst_pairs.size() / 100)) * 100;
-		auto& src_dst_pair = src_dst_pairs[src_dst_index];
-		traffic.push_back(make_tuple(flow.first, flow.second, src_dst_pair.first, src_dst_pair.second));
-		// cout << flow.first << ", " << flow.second << ", " << src_dst_pair.first << ", " << src_dst_pair.second << endl;
+	next_.src = src;
+	next_.dst = src + 1 + pair_index;
+}
+
+bool StochasticTrafficSource::HasNext() const {
+	return next_.arrival < sim_duration_;
+}
+
+const FlowArrival& StochasticTrafficSource::Peek() const {
+	assert(HasNext());
+	return next_;
+}
+
+FlowArrival StochasticTrafficSource::Next() {
+	const FlowArrival flow = Peek();
+	count_++;
+	Sample();
+	return flow;
+}
+
+vector<FlowArrival> GenerateTraffic(const Scenario& scenario) {
+	vector<FlowArrival> traffic;
+	StochasticTrafficSource source(scenario);
+	while(source.HasNext()) {
+		traffic.push_back(source.Next());
+		// cout << traffic.back().arrival << ", " << traffic.back().volume << ", " << traffic.back().src << ", " << traffic.back().dst << endl;
 	}
 	return traffic;
 }
 
-void RunSimulations(vector<Scenario> scenarios, vector<RouterFactory::RouterType> routers) {
-	Logger logger("stats/matrix_" + to_string(GenerateTimestamp()) + ".m");
-	// Iterate over scenarios and run the routers on each scenario.
-	// Write the output for each scenario.
-	for(Scenario& scenario : scenarios) {
-		auto traffic = GenerateTraffic(scenario);
-		for(RouterFactory::RouterType router_type : routers) {
-			cout << "Starting router " << static_cast<int>(router_type) << " over " << traffic.size() << " flows..." << endl << endl;
-			FlowRouter* router = RouterFactory::BuildRouter(router_type, scenario.topo);
-			int index = 0, next_time = 0;
-			while(index < traffic.size() || router->getRemainingFlows() > 0) {
-				while(index < traffic.size() && get<0>(traffic[index]) < router->getEpoch()) {
-					cout << index << " " << flush;
-					router->PostFlow(Flow(index, 
-						scenario.topo->GetNode(get<2>(traffic[index])), 
-						scenario.topo->GetNode(get<3>(traffic[index])), 
-						get<1>(traffic[index])));
-					index++;
-				}
-				router->NextSlot();
-				if(router->getEpoch() >= next_time) {
-					cout.precision(5);
-					cout << (next_time < 10 ? "" : "]") << endl << "[ " << static_cast<int>(router_type) << " ] Rem Flows: " << router->getRemainingFlows() << 
-									"\tRemaining Vol: " << round(router->GetTotalRemainingDemand()) << 
-									"\tElapsed: " << round(router->getEpoch()) << 
-									"\tFlow Index: [ ";
-					next_time += 10;
-				}
+namespace {
+
+// Run one router over the traffic of a scenario until all flows are complete.
+void SimulateRouter(const Scenario& scenario, TrafficSource& source,
+                    RouterFactory::RouterType router_type, FlowRouter* router, bool verbose) {
+	const bool event_driven = (scenario.mode == SimulationMode::EVENTS);
+	int next_time = 0;
+	vector<Flow> arrivals;
+	while(source.HasNext() || router->getRemainingFlows() > 0) {
+		// Timeslots admit flows at the first slot boundary after their arrival, events admit them on arrival.
+		// Flows admitted at the same epoch are posted as one batch.
+		arrivals.clear();
+		while(source.HasNext() && (source.Peek().arrival < router->getEpoch() || 
+				(event_driven && source.Peek().arrival == router->getEpoch()))) {
+			const int index = source.GetCount();
+			const FlowArrival flow = source.Next();
+			if(verbose) {
+				cout << index << " " << flush;
 			}
-			cout << endl;
-			logger.Log(scenario, static_cast<int>(router_type), router->GetCompletionTimes());
-			delete router;
+			arrivals.push_back(Flow(index, 
+				scenario.topo->GetNode(flow.src), 
+				scenario.topo->GetNode(flow.dst), 
+				flow.volume, 
+				flow.arrival));
+		}
+		router->PostFlows(arrivals);
+		// The last flows were dropped for having no path.
+		if(!source.HasNext() && router->getRemainingFlows() == 0) {
+			break;
+		}
+		if(event_driven) {
+			router->NextEvent(source.HasNext() ? source.Peek().arrival : numeric_limits<double>::infinity());
+		} else {
+			router->NextSlot();
+		}
+		if(verbose && router->getEpoch() >= next_time) {
+			cout.precision(5);
+			cout << (next_time < 10 ? "" : "]") << endl << "[ " << static_cast<int>(router_type) << " ] Rem Flows: " << router->getRemainingFlows() << 
+							"\tRemaining Vol: " << round(router->GetTotalRemainingDemand()) << 
+							"\tElapsed: " << round(router->getEpoch()) << 
+							"\tFlow Index: [ ";
+			next_time += 10;
+		}
+	}
+	if(verbose) {
+		cout << endl;
+	}
+	if(router->GetUnroutableFlows() > 0) {
+		cerr << "[ " << static_cast<int>(router_type) << " ] Dropped " << router->GetUnroutableFlows() << 
+			" flows without a path to their destination" << endl;
+	}
+}
+
+// Write the instrumentation of every run as a matrix, one row per (scenario, router) in the
+// order of the rows of the results matrix.
+void WriteInstrumentation(const string& filename, const vector<RouterFactory::RouterType>& routers, 
+                          const vector<Instrumentation>& runs) {
+	FILE* file = fopen(filename.c_str(), "w");
+	assert(file != NULL);
+	stringstream ss;
+	ss << "% scenario, router";
+	for(int phase = 0; phase < NUM_PHASES; phase++) {
+		ss << ", " << PhaseName(static_cast<Phase>(phase));
+	}
+	for(int counter = 0; counter < NUM_COUNTERS; counter++) {
+		ss << ", " << CounterName(static_cast<Counter>(counter));
+	}
+	ss << "\r\ninstrumentation = [\r\n";
+	for(size_t job = 0; job < runs.size(); job++) {
+		ss << (job / routers.size()) << ", " << static_cast<int>(routers[job % routers.size()]);
+		for(const double seconds : runs[job].seconds) {
+			ss << ", " << seconds;
+		}
+		for(const uint64_t count : runs[job].counts) {
+			ss << ", " << count;
+		}
+		ss << ";\r\n";
+	}
+	ss << "]\r\n";
+	const string data = ss.str();
+	cout << "Logging " << data.size() << " bytes into " << filename << endl << endl;
+	int error = fputs(data.c_str(), file);
+	assert(error >= 0);
+	error = fclose(file);
+	assert(error == 0);
+}
+
+} // namespace
+
+void RunSimulations(vector<Scenario> scenarios, vector<RouterFactory::RouterType> routers, int threads) {
+	const long timestamp = GenerateTimestamp();
+	Logger logger("stats/matrix_" + to_string(timestamp) + ".m");
+	// Freeze the topologies up front so the runs only ever read them (scenarios may share one).
+	// Clock seeds are fixed here as well, every router of a scenario must see the same traffic.
+	// Trace files are mapped once and shared read-only by all runs that replay them.
+	map<string, unique_ptr<MappedTrace>> traces;
+	for(Scenario& scenario : scenarios) {
+		scenario.topo->GetCSR();
+		if(scenario.seed == 0) {
+			scenario.seed = timestamp;
+		}
+		if(!scenario.trace.empty() && traces.count(scenario.trace) == 0) {
+			traces[scenario.trace].reset(new MappedTrace(scenario.trace));
+		}
+	}
+	// Iterate over scenarios and run the routers on each scenario.
+	// Write the output for each scenario. Each run pulls its flows from its own source.
+	ThreadPool pool(threads);
+	const bool verbose = (pool.GetThreads() == 1);
+	// With more threads than runs the spare ones go to the rate computation of each run.
+	const int jobs = scenarios.size() * routers.size();
+	const int rate_threads = max(1, pool.GetThreads() / max(jobs, 1));
+	mutex cout_mutex;
+	vector<Instrumentation> instrumentation(jobs);
+	pool.ParallelFor(jobs, [&](int job) {
+		const Scenario& scenario = scenarios[job / routers.size()];
+		const RouterFactory::RouterType router_type = routers[job % routers.size()];
+		{
+			lock_guard<mutex> lock(cout_mutex);
+			cout << "Starting router " << static_cast<int>(router_type) << " on scenario " << (job / routers.size()) << "..." << endl << endl;
+		}
+		unique_ptr<TrafficSource> source;
+		if(scenario.trace.empty()) {
+			source.reset(new StochasticTrafficSource(scenario));
+		} else {
+			source.reset(new TraceTrafficSource(*traces.at(scenario.trace), scenario));
+		}
+		unique_ptr<FlowRouter> router(RouterFactory::BuildRouter(router_type, scenario.topo));
+		router->SetVerificationLevel(scenario.verification);
+		router->SetRateThreads(rate_threads);
+		unique_ptr<FlowRecordWriter> records;
+		if(scenario.flow_records) {
+			records.reset(new FlowRecordWriter("stats/flows_" + to_string(timestamp) + "_" + to_string(job) + ".bin", scenario.topo));
+			router->SetCompletionCallback([&records](Flow* flow, double completion) {
+				records->Write(flow, completion);
+			});
 		}
+		SimulateRouter(scenario, *source, router_type, router.get(), verbose);
+		records.reset();
+		logger.Log(job, scenario, static_cast<int>(router_type), router->GetCompletionTimes());
+		instrumentation[job] = router->GetInstrumentation();
+	});
+	if(INSTRUMENTATION_ENABLED) {
+		WriteInstrumentation("stats/instrumentation_" + to_string(timestamp) + ".m", routers, instrumentation);
 	}
 }
 
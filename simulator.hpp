@@ -5,10 +5,12 @@
 #ifndef SIMULATOR_HPP
 #define SIMULATOR_HPP
 
+#include <cstdint>
 #include <cstdio>
 
 #include <vector>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
@@ -21,6 +23,12 @@ using namespace std;
 
 namespace Network {
 
+// How the simulation epoch advances.
+enum class SimulationMode {
+  TIMESLOTS, // Fixed steps of TIMESLOT_DURATION (FlowRouter::NextSlot).
+  EVENTS,    // From one flow arrival or completion to the next (FlowRouter::NextEvent).
+};
+
 struct Scenario {
   // Traffic parameters specified for Stochastic object to generate flows.
   double lambda;
@@ -29,27 +37,95 @@ struct Scenario {
   double sim_duration;
   // Topology supplied to the FlowRouter object.
   Topology* topo;
+  SimulationMode mode;
+  // Seed and stream id of the generated traffic, a zero seed seeds from the clock.
+  // Scenarios that share a seed but not a stream get independent traffic.
+  uint64_t seed;
+  uint64_t stream;
+  // Binary trace file (see trace.hpp) to replay instead of sampling the traffic, if not empty.
+  // Only its flows that arrive within sim_duration are used.
+  string trace;
+  // Consistency checks of the routers (never more than the build allows, see flow_router.hpp).
+  VerificationLevel verification;
+  // Write a record of every completed flow (see flow_records.hpp) of each run to
+  // stats/flows_<timestamp>_<row>.bin, where row is the row of the run in the results.
+  bool flow_records;
 
-  Scenario(double lambda_, double mu_, Stochastic::DistributionTypes dist_type_, double sim_duration_, Topology* topo_) : 
-    lambda(lambda_), mu(mu_), dist_type(dist_type_), sim_duration(sim_duration_), topo(topo_) {}
+  Scenario(double lambda_, double mu_, Stochastic::DistributionTypes dist_type_, double sim_duration_, Topology* topo_,
+           SimulationMode mode_ = SimulationMode::TIMESLOTS, uint64_t seed_ = 0, uint64_t stream_ = 0, string trace_ = "",
+           VerificationLevel verification_ = VerificationLevel::FULL, bool flow_records_ = false) : 
+    lambda(lambda_), mu(mu_), dist_type(dist_type_), sim_duration(sim_duration_), topo(topo_), mode(mode_),
+    seed(seed_), stream(stream_), trace(trace_), verification(verification_), flow_records(flow_records_) {}
 };
 
+// Writes one row per (scenario, router) run. Safe to call from several threads, rows are
+// written in the order of their row numbers no matter in which order they are logged.
 class Logger {
 public:
   explicit Logger(string filename);
   ~Logger();
-  void Log(const Scenario& scenario, const int router_id, vector<double> completion_times);
+  void Log(int row, const Scenario& scenario, const int router_id, const QuantileSketch& completion_times);
   void Close();
 private:
   const string filename_;
   FILE* const file_;
+  mutex mutex_;
+  map<int, string> pending_rows_; // Rows logged ahead of next_row_.
+  int next_row_;
 };
 
 long GenerateTimestamp();
 
-vector<tuple<double, double, int, int>> GenerateTraffic(Scenario& scenario);
+// A sampled flow: when it arrives, its volume and the ids of its end nodes.
+struct FlowArrival {
+  double arrival;
+  double volume;
+  int src, dst;
+};
+
+// Pull-based source of flows in arrival order, consumed by the simulation as the epoch advances.
+class TrafficSource {
+public:
+  virtual ~TrafficSource() {}
+  // False once there are no more flows within the scenario duration.
+  virtual bool HasNext() const = 0;
+  // The flow that Next() returns, without consuming it.
+  virtual const FlowArrival& Peek() const = 0;
+  virtual FlowArrival Next() = 0;
+  // Number of flows consumed so far.
+  int GetCount() const {
+    return count_;
+  }
+protected:
+  int count_ = 0;
+};
+
+// Samples the flows of a scenario one at a time as they are consumed, so memory does not
+// grow with the simulated duration. Sources built from the same scenario yield the same
+// flows (unless its seed is zero).
+class StochasticTrafficSource : public TrafficSource {
+public:
+  explicit StochasticTrafficSource(const Scenario& scenario);
+  bool HasNext() const override;
+  const FlowArrival& Peek() const override;
+  FlowArrival Next() override;
+private:
+  void Sample();
+  Stochastic dist_;
+  const double sim_duration_;
+  const int nodes_;
+  const long long num_pairs_; // Pairs (src, dst) with src < dst.
+  FlowArrival next_;
+};
+
+// Sample all flows of a scenario, reproducible for a fixed seed and stream.
+vector<FlowArrival> GenerateTraffic(const Scenario& scenario);
 
-void RunSimulations(vector<Scenario> scenarios, vector<RouterFactory::RouterType> routers);
+// Run every router over every scenario. The runs are independent and spread over a pool of
+// threads (zero means one per hardware thread), rows are logged in scenario then router order.
+// Builds with BWR_INSTRUMENTATION also write the instrumentation of every run, in the same
+// order, to stats/instrumentation_<timestamp>.m next to the results.
+void RunSimulations(vector<Scenario> scenarios, vector<RouterFactory::RouterType> routers, int threads = 0);
 
 } // namespace Network
 
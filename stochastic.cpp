@@ -2,6 +2,9 @@
 // Copyright 2019
 // Can be distributed under MIT license (https://opensource.org/licenses/MIT)
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 
 #include <vector>
@@ -15,8 +18,57 @@ using namespace std;
 
 namespace Network {
 
+namespace {
+
+// SplitMix64 step, used to spread a seed over the engine state.
+uint64_t SplitMix64(uint64_t& x) {
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+inline uint64_t RotateLeft(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+} // namespace
+
+Stochastic::Stochastic(double lambda, double mu, DistributionTypes job_size_dist, uint64_t seed, uint64_t stream) : 
+	lambda_(lambda), mu_(mu), job_size_dist_(job_size_dist), t_fraction_(0.0) {
+	if(seed == 0) {
+		auto epoch = std::chrono::system_clock::now().time_since_epoch();
+		seed = std::chrono::duration_cast<std::chrono::milliseconds>(epoch).count();
+	}
+	// Hash the stream id before mixing it in so that nearby seeds and streams do not overlap.
+	uint64_t mixed_stream = stream;
+	uint64_t x = seed ^ SplitMix64(mixed_stream);
+	for(uint64_t& word : state_) {
+		word = SplitMix64(x);
+	}
+}
+
+uint64_t Stochastic::nextRandom() {
+	const uint64_t result = RotateLeft(state_[1] * 5, 7) * 9;
+	const uint64_t t = state_[1] << 17;
+	state_[2] ^= state_[0];
+	state_[3] ^= state_[1];
+	state_[1] ^= state_[2];
+	state_[0] ^= state_[3];
+	state_[2] ^= t;
+	state_[3] = RotateLeft(state_[3], 45);
+	return result;
+}
+
 double Stochastic::genRand() {
-	return (static_cast<double>(rand() + 1) / RAND_MAX);
+	// The top 53 bits give a double in (0, 1], zero is excluded since samples take its log.
+	return static_cast<double>((nextRandom() >> 11) + 1) / 9007199254740992.0; // 2^53
+}
+
+uint64_t Stochastic::genIndex(uint64_t n) {
+	assert(n > 0);
+	// Multiply-shift maps 64 random bits onto [0, n) without a division.
+	return static_cast<uint64_t>((static_cast<unsigned __int128>(nextRandom()) * n) >> 64);
 }
 
 double Stochastic::expGen() {
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <random>
 #include <vector>
 #include <map>
@@ -27,14 +28,19 @@ public:
         DIST_FB_HADOOP,
     };
 
-	Stochastic(double lambda, double mu, DistributionTypes job_size_dist) : 
-		lambda_(lambda), mu_(mu), job_size_dist_(job_size_dist), t_fraction_(0.0) {
-		    auto epoch = std::chrono::system_clock::now().time_since_epoch();
-		    srand(std::chrono::duration_cast<std::chrono::milliseconds>(epoch).count());
-		}
+	// Samples are drawn from a private xoshiro256** engine, so instances never share state.
+	// The same (seed, stream) pair always yields the same samples, different streams of a
+	// seed are independent sequences. A zero seed is replaced by the wall clock.
+	Stochastic(double lambda, double mu, DistributionTypes job_size_dist, uint64_t seed = 0, uint64_t stream = 0);
 
 	pair<double, double> nextSample(); // Returns a pair<arrival, volume> that is a sampled flow.
 
+	// Generate an integer uniformly distributed in [0, n).
+	uint64_t genIndex(uint64_t n);
+
+	// Generate a double uniformly distributed in (0, 1].
+	double genRand();
+
 private:
 	// Parameters used to generate traffic.
 	const double lambda_, mu_;
@@ -42,9 +48,10 @@ private:
 
 	// Parameters used to generate samples.
 	double t_fraction_;
+	uint64_t state_[4];
 
-	// Generate a double uniformly distributed in [0, 1].
-    double genRand();
+	// Advance the engine and return the next 64 random bits.
+	uint64_t nextRandom();
 
     // Generate a sample distributed according to any of the following distributions.
     double expGen();    
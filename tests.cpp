@@ -2,7 +2,11 @@
 // Copyright 2019
 // Can be distributed under MIT license (https://opensource.org/licenses/MIT)
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 
 #include "tests.hpp"
 
@@ -393,6 +397,619 @@ void TestDistribution(Stochastic::DistributionTypes dist_type) {
   }
 }
 
+void TestStochasticSeeding() {
+  cout << endl << "TestStochasticSeeding" << endl;
+  // The same seed and stream reproduce the same samples.
+  Stochastic dist1(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 42, 0);
+  Stochastic dist2(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 42, 0);
+  // Another stream of the same seed is a different sequence.
+  Stochastic dist3(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 42, 1);
+  int differences = 0;
+  for(int index = 0; index < 1000; index++) {
+    pair<double, double> flow1 = dist1.nextSample(), flow2 = dist2.nextSample(), flow3 = dist3.nextSample();
+    assert(flow1 == flow2);
+    differences += (flow1 != flow3);
+    uint64_t pick1 = dist1.genIndex(7), pick2 = dist2.genIndex(7);
+    assert(pick1 == pick2 && pick1 < 7);
+    dist3.genIndex(7);
+  }
+  assert(differences == 1000);
+  // Fewer than 100 node pairs (GSCALE has 66) still give valid flows.
+  Topology* topo = BuildTopologyGSCALE();
+  StochasticTrafficSource source(Scenario(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 100.0, topo,
+                                          SimulationMode::TIMESLOTS, 42));
+  while(source.HasNext()) {
+    const FlowArrival flow = source.Next();
+    assert(flow.src == 0 && flow.dst == 1);
+  }
+  assert(source.GetCount() > 0);
+  delete topo;
+}
+
+void TestTrace() {
+  cout << endl << "TestTrace" << endl;
+  Topology* topo = BuildTopology();
+  const string filename = "test_trace.bin";
+  const vector<FlowArrival> flows = {{0.5, 1.0, 0, 3}, {1.5, 2.0, 1, 2}, {2.5, 3.0, 3, 0}};
+  {
+    TraceWriter writer(filename);
+    for(const FlowArrival& flow : flows) {
+      writer.Write(flow);
+    }
+  }
+  MappedTrace trace(filename);
+  assert(trace.Size() == flows.size());
+  // Only the flows that arrive within the duration are replayed.
+  Scenario scenario(1.0, 0.1, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 2.0, topo);
+  TraceTrafficSource source(trace, scenario);
+  for(int index = 0; index < 2; index++) {
+    assert(source.HasNext());
+    const FlowArrival flow = source.Next();
+    assert(flow.arrival == flows[index].arrival && flow.volume == flows[index].volume);
+    assert(flow.src == flows[index].src && flow.dst == flows[index].dst);
+  }
+  assert(!source.HasNext() && source.GetCount() == 2);
+  auto open_error = [](const string& filename, const string& contents) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    assert(file != NULL);
+    fwrite(contents.data(), 1, contents.size(), file);
+    fclose(file);
+    string message;
+    try {
+      MappedTrace trace(filename);
+    } catch(const runtime_error& error) {
+      message = error.what();
+    }
+    remove(filename.c_str());
+    cout << message << endl;
+    return message;
+  };
+  const string contents(static_cast<const char*>(static_cast<const void*>(trace.begin())) - sizeof(TraceHeader),
+                        sizeof(TraceHeader) + flows.size() * sizeof(FlowArrival));
+  assert(open_error("test_trace_copy.bin", contents).empty());
+  assert(open_error("test_trace_short.bin", contents.substr(0, sizeof(TraceHeader) - 1)) ==
+         "test_trace_short.bin: shorter than the header");
+  assert(open_error("test_trace_truncated.bin", contents.substr(0, contents.size() - 8)).find(
+         "test_trace_truncated.bin: truncated") == 0);
+  assert(open_error("test_trace_magic.bin", "BWRFLOWS" + contents.substr(8)) ==
+         "test_trace_magic.bin: not a BWRTRACE file");
+  try {
+    MappedTrace missing("test_trace_missing.bin");
+    assert(false);
+  } catch(const runtime_error& error) {
+    assert(string(error.what()).find("test_trace_missing.bin: ") == 0);
+  }
+  // A trace of a larger topology.
+  const string nodes_filename = "test_trace_nodes.bin";
+  {
+    TraceWriter writer(nodes_filename);
+    writer.Write({0.5, 1.0, 0, static_cast<int>(topo->GetNodes().size())});
+  }
+  MappedTrace other_trace(nodes_filename);
+  TraceTrafficSource other_source(other_trace, scenario);
+  string message;
+  try {
+    other_source.Next();
+  } catch(const runtime_error& error) {
+    message = error.what();
+  }
+  cout << message << endl;
+  assert(message.find("test_trace_nodes.bin: flow 0 goes from node 0") == 0);
+  remove(nodes_filename.c_str());
+  remove(filename.c_str());
+  delete topo;
+}
+
+void TestFlowRecords() {
+  cout << endl << "TestFlowRecords" << endl;
+  Topology* topo = BuildTopology();
+  const string filename = "test_flow_records.bin";
+  {
+    FlowRecordWriter writer(filename, topo);
+    ShortestPathRouter router(topo, ShortestPathRouter::TECHNIQUE::BY_HOPS);
+    router.SetCompletionCallback([&writer](Flow* flow, double completion) {
+      writer.Write(flow, completion);
+    });
+    router.PostFlow(Flow(0, topo->GetNode(0), topo->GetNode(3), 1.0, 0.5));
+    router.PostFlow(Flow(1, topo->GetNode(0), topo->GetNode(2), 2.0, 0.5));
+    while(router.getRemainingFlows() > 0) {
+      router.NextSlot();
+    }
+  }
+  MappedFlowRecords records(filename);
+  assert(records.Size() == 2);
+  for(const FlowRecord& record : records) {
+    cout << "Flow " << record.id << ": FCT " << record.GetFCT() << ", slowdown " << record.GetSlowdown() << endl;
+    assert(record.arrival == 0.5 && record.src == 0 && record.dst == (record.id == 0 ? 3 : 2));
+    assert(record.hops == 2 && record.paths == 1);
+    // The widest paths are 0-4-1-3 (0.5) and 0-4-1-2 (1.0).
+    assert(record.ideal_fct == (record.id == 0 ? 1.0 / 0.5 : 2.0 / 1.0));
+    assert(record.GetSlowdown() >= 1.0);
+  }
+  remove(filename.c_str());
+  delete topo;
+}
+
+void TestObjectPool() {
+  cout << endl << "TestObjectPool" << endl;
+  ObjectPool<vector<int>, 2> pool;
+  vector<int>* first = pool.New({1, 2, 3});
+  vector<int>* second = pool.New({4});
+  vector<int>* third = pool.New({5, 6}); // Starts a new chunk.
+  assert(pool.Size() == 3 && *second == vector<int>({4}) && *third == vector<int>({5, 6}));
+  // A recycled object is handed out again, its buffer is reused.
+  const int* buffer = first->data();
+  pool.Recycle(first);
+  assert(pool.Size() == 2);
+  vector<int>* fourth = pool.New({7, 8});
+  assert(fourth == first && fourth->data() == buffer && *fourth == vector<int>({7, 8}));
+}
+
+void TestThreadPool() {
+  cout << endl << "TestThreadPool" << endl;
+  ThreadPool pool(3);
+  vector<int> done(100, 0);
+  pool.ParallelFor(done.size(), [&done](int job) {
+    done[job]++;
+  });
+  assert(count(done.begin(), done.end(), 1) == static_cast<long>(done.size()));
+  // A throwing job stops the batch and its exception comes out of ParallelFor.
+  string message;
+  try {
+    pool.ParallelFor(1000, [](int job) {
+      if(job == 10) {
+        throw runtime_error("job 10");
+      }
+    });
+  } catch(const runtime_error& error) {
+    message = error.what();
+  }
+  assert(message == "job 10");
+  // The pool is still usable.
+  pool.ParallelFor(done.size(), [&done](int job) {
+    done[job]++;
+  });
+  assert(count(done.begin(), done.end(), 2) == static_cast<long>(done.size()));
+}
+
+void TestFlowProgress() {
+  cout << endl << "TestFlowProgress" << endl;
+  // More flows than one vector holds so that both the vector and the scalar loop run.
+  const int flows = 19;
+  vector<double> size(flows), completed(flows), rate(flows);
+  for(int index = 0; index < flows; index++) {
+    size[index] = 10.0 + index;
+    completed[index] = index;
+    rate[index] = (index % 3 == 0) ? 0.0 : 1.0;
+  }
+  // Flow 17 is capped in a step of 2, flow 18 completes in this step.
+  rate[17] = 5.0;
+  completed[18] = 27.5;
+  rate[18] = 1.0;
+  ProgressSummary summary = AdvanceFlows(completed.data(), size.data(), rate.data(), flows, 0.5, 2.0);
+  assert(summary.completed && summary.capped);
+  assert(completed[0] == 0.0 && completed[1] == 1.5 && completed[17] == 19.5 && completed[18] == 28.0);
+  // Without them nothing is complete and an infinite step never caps.
+  summary = AdvanceFlows(completed.data(), size.data(), rate.data(), flows - 2, 1.0, numeric_limits<double>::infinity());
+  assert(!summary.completed && !summary.capped);
+  // The sending flows have 8.5 left at rate 1, flow 17 has 7.5 at rate 5.
+  assert(EarliestCompletion(completed.data(), size.data(), rate.data(), flows - 2) == 8.5);
+  assert(EarliestCompletion(completed.data(), size.data(), rate.data(), flows - 1) == 1.5);
+  assert(EarliestCompletion(completed.data(), size.data(), rate.data(), 1) == numeric_limits<double>::infinity());
+}
+
+void TestInstrumentation() {
+  cout << endl << "TestInstrumentation" << endl;
+  Instrumentation totals, scratch;
+  {
+    InstrumentationScope scope(totals);
+    Count(Counter::HEAP_PUSHES, 3);
+    // Counted elsewhere, then collected by this thread.
+    Count(scratch, Counter::FLOWS_FROZEN, 2);
+    Collect(scratch);
+  }
+  // Not within the scope.
+  Count(Counter::HEAP_PUSHES);
+  const uint64_t enabled = INSTRUMENTATION_ENABLED ? 1 : 0;
+  assert(totals.Count(Counter::HEAP_PUSHES) == 3 * enabled);
+  assert(totals.Count(Counter::FLOWS_FROZEN) == 2 * enabled);
+  assert(totals.Count(Counter::HEAP_POPS) == 0 && scratch.Count(Counter::FLOWS_FROZEN) == 0);
+}
+
+void TestQuantileSketch() {
+  cout << endl << "TestQuantileSketch" << endl;
+  const vector<double> fractions = {0.0, 0.01, 0.5, 0.95, 0.99, 1.0};
+  Stochastic random(1.0, 0.1, Stochastic::DistributionTypes::DIST_PARETO, 1);
+  vector<double> values;
+  QuantileSketch sketch, first, second;
+  for(int index = 0; index < 4 * SKETCH_EXACT_SAMPLES; index++) {
+    values.push_back(random.nextSample().second);
+    sketch.Add(values.back());
+    (index % 3 == 0 ? first : second).Add(values.back());
+    if(index == 100) {
+      // Small samples are exact.
+      vector<double> sorted(values);
+      sort(sorted.begin(), sorted.end());
+      for(const double fraction : fractions) {
+        assert(sketch.Quantile(fraction) == sorted[min<size_t>(sorted.size() * fraction, sorted.size() - 1)]);
+      }
+    }
+  }
+  sort(values.begin(), values.end());
+  double mean = 0.0;
+  for(const double value : values) {
+    mean += value / values.size();
+  }
+  assert(sketch.Count() == values.size() && sketch.Min() == values.front() && sketch.Max() == values.back());
+  assert(abs(sketch.Mean() - mean) < 1E-9 * mean);
+  // Merging the halves gives the same summary.
+  first.Merge(second);
+  assert(first.Count() == sketch.Count() && abs(first.Mean() - sketch.Mean()) < 1E-9 * mean);
+  assert(abs(first.Variance() - sketch.Variance()) < 1E-9 * sketch.Variance());
+  for(const double fraction : fractions) {
+    const double expected = values[min<size_t>(values.size() * fraction, values.size() - 1)];
+    cout << "Quantile " << fraction << ": " << sketch.Quantile(fraction) << " (" << expected << ")" << endl;
+    assert(abs(sketch.Quantile(fraction) - expected) <= SKETCH_RELATIVE_ACCURACY * expected);
+    assert(first.Quantile(fraction) == sketch.Quantile(fraction));
+  }
+  // Small samples stay exact through merges.
+  QuantileSketch small_first, small_second;
+  for(int index = 0; index < 200; index++) {
+    (index % 2 == 0 ? small_first : small_second).Add(values[(index * 7919) % values.size()]);
+  }
+  small_first.Merge(small_second);
+  vector<double> small_values;
+  for(int index = 0; index < 200; index++) {
+    small_values.push_back(values[(index * 7919) % values.size()]);
+  }
+  sort(small_values.begin(), small_values.end());
+  for(const double fraction : fractions) {
+    assert(small_first.Quantile(fraction) == small_values[min<size_t>(200 * fraction, 199)]);
+  }
+}
+
+void TestWaterFilling() {
+  cout << endl << "TestWaterFilling" << endl;
+  Topology* topo = BuildTopology();
+  WaterFilling water_filling(topo);
+  // Two flows share edge 0-1 (0.2), one of them can only use 0.05.
+  // Another two flows share edge 2-3 (0.2) and the third edge 0-4 (1.0) is used by one flow.
+  vector<pair<int, int>> hops = {{0, 1}, {0, 1}, {2, 3}, {2, 3}, {0, 4}};
+  vector<double> sizes = {100, 100, 0.05, 100, 100};
+  vector<double> expected = {0.1, 0.1, 0.05, 0.15, 1.0};
+  vector<Flow*> flows;
+  unordered_map<int, Flow*> flows_map;
+  for(int id = 0; id < hops.size(); id++) {
+    Node* const src = topo->GetNode(hops[id].first);
+    Node* const dst = topo->GetNode(hops[id].second);
+    Flow* flow = new Flow(id, src, dst, sizes[id]);
+    Path* path = new Path(id);
+    path->AddEdge(topo->GetEdge(src, dst));
+    flow->AddPath(path);
+    flows.push_back(flow);
+    flows_map[id] = flow;
+  }
+  unordered_map<Path*, double> rates = water_filling.Allocate(flows_map, 1.0);
+  for(int id = 0; id < flows.size(); id++) {
+    Path* const path = flows[id]->GetPaths()[0];
+    cout << "Rate: " << rates[path] << " Path: ";
+    PathsPrint(path);
+    assert(abs(rates[path] - expected[id]) < 1E-9);
+    delete path;
+    delete flows[id];
+  }
+  delete topo;
+}
+
+void TestTopologyCSR() {
+  cout << endl << "TestTopologyCSR" << endl;
+  Topology* topo = BuildTopology();
+  const CSRGraph& csr = topo->GetCSR();
+  assert(topo->IsFrozen());
+  assert(csr.NumNodes() == topo->GetNodes().size());
+  assert(csr.NumEdges() == topo->GetEdges().size());
+  // The CSR rows must list the same edges as the adjacency lists, in the same order.
+  for(Node* const node : topo->GetNodes()) {
+    const vector<pair<Edge*, Node*> >& adj = topo->GetAdjList(node);
+    assert(csr.offsets[node->GetID() + 1] - csr.offsets[node->GetID()] == adj.size());
+    for(int i = 0; i < adj.size(); i++) {
+      const int edge_id = csr.adj_edges[csr.offsets[node->GetID()] + i];
+      assert(edge_id == adj[i].first->GetID());
+      assert(csr.adj_nodes[csr.offsets[node->GetID()] + i] == adj[i].second->GetID());
+      assert(csr.capacities[edge_id] == adj[i].first->GetCap());
+      assert(topo->GetEdgeID(node->GetID(), adj[i].second->GetID()) == edge_id);
+      assert(topo->GetEdge(node, adj[i].second) == adj[i].first);
+    }
+  }
+  assert(topo->GetEdgeID(0, 2) == -1);
+  assert(topo->GetEdge(topo->GetNode(0), topo->GetNode(2)) == NULL);
+  delete topo;
+}
+
+void TestTopologyLoader() {
+  cout << endl << "TestTopologyLoader" << endl;
+  // The edges of BuildTopology(), the file does not end in a newline.
+  const string edge_list = "test_topology.topo";
+  FILE* file = fopen(edge_list.c_str(), "w");
+  assert(file != NULL);
+  fputs("# Test topology.\nnodes 5\ndirected\n\n0 1 0.2 # Slow link.\n0 4 1\n"
+        "1 0 0.2\n1 2 1.8\n1 3 0.5\n1 4 1.5\n2 1 1.8\n2 3 0.2\n3 1 0.5\n3 2 0.2\n"
+        "4 0 1\n\t4   1 1.5e0", file);
+  fclose(file);
+  Topology* expected = BuildTopology();
+  Topology* topo = LoadTopology(edge_list);
+  assert(topo->GetName() == "test_topology");
+  assert(topo->GetNodes().size() == expected->GetNodes().size());
+  assert(topo->GetEdges().size() == expected->GetEdges().size());
+  for(Edge* const edge : expected->GetEdges()) {
+    Edge* const loaded = topo->GetEdges()[edge->GetID()];
+    assert(loaded->GetSrc()->GetID() == edge->GetSrc()->GetID());
+    assert(loaded->GetDst()->GetID() == edge->GetDst()->GetID());
+    assert(loaded->GetCap() == edge->GetCap());
+  }
+  remove(edge_list.c_str());
+  delete topo;
+  delete expected;
+
+  // Zoo style GraphML with string node ids, a parallel link, a self loop and a link without speed.
+  const string graphml = "test_topology.graphml";
+  file = fopen(graphml.c_str(), "w");
+  assert(file != NULL);
+  fputs("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+        "  <key attr.name=\"LinkSpeedRaw\" attr.type=\"double\" for=\"edge\" id=\"d1\" />\n"
+        "  <key attr.name=\"Network\" attr.type=\"string\" for=\"graph\" id=\"d0\" />\n"
+        "  <graph edgedefault=\"undirected\">\n"
+        "    <data key=\"d0\">A &amp; B</data>\n"
+        "    <!-- <node id=\"x\"/> -->\n"
+        "    <node id=\"a\"><data key=\"d2\">City</data></node>\n"
+        "    <node id=\"b\" />\n"
+        "    <node id=\"c\" />\n"
+        "    <edge source=\"a\" target=\"b\"><data key=\"d1\"> 1000000000.0 </data></edge>\n"
+        "    <edge source=\"b\" target=\"a\"><data key=\"d1\">1000000000.0</data></edge>\n"
+        "    <edge source=\"b\" target=\"c\"><data key=\"d1\">500000000.0</data></edge>\n"
+        "    <edge source=\"c\" target=\"c\"><data key=\"d1\">1000000000.0</data></edge>\n"
+        "    <edge source=\"a\" target=\"c\" />\n"
+        "  </graph>\n"
+        "</graphml>\n", file);
+  fclose(file);
+  topo = LoadTopology(graphml);
+  assert(topo->GetName() == "A & B");
+  assert(topo->GetNodes().size() == 3 && topo->GetEdges().size() == 6);
+  assert(topo->GetEdge(topo->GetNode(0), topo->GetNode(1))->GetCap() == 1.0);
+  assert(topo->GetEdge(topo->GetNode(2), topo->GetNode(1))->GetCap() == 0.25);
+  assert(topo->GetEdge(topo->GetNode(0), topo->GetNode(2))->GetCap() == 1.0);
+  assert(topo->GetEdgeID(2, 2) == -1);
+  remove(graphml.c_str());
+  delete topo;
+
+  // Malformed files throw with the file name and line of the problem.
+  auto load_error = [](const string& filename, const char* contents) {
+    if(contents != NULL) {
+      FILE* file = fopen(filename.c_str(), "w");
+      assert(file != NULL);
+      fputs(contents, file);
+      fclose(file);
+    }
+    string message;
+    try {
+      delete LoadTopology(filename);
+    } catch(const runtime_error& error) {
+      message = error.what();
+    }
+    remove(filename.c_str());
+    cout << message << endl;
+    return message;
+  };
+  const char* const speed_key =
+    "<graphml><key attr.name=\"LinkSpeedRaw\" for=\"edge\" id=\"d1\"/><graph>\n";
+  assert(load_error("test_missing.topo", NULL).find("test_missing.topo") == 0);
+  assert(load_error("test_bad.topo", "nodes 3\n0 x 1\n").find("test_bad.topo:2: expected") == 0);
+  assert(load_error("test_bad.topo", "nodes 3\n0 3 1\n").find("test_bad.topo:2: node 3 is out of range") == 0);
+  assert(load_error("test_bad.topo", "nodes 3\n0 1 1\n1 0 1\n") == "test_bad.topo:3: link 1 - 0 is listed twice");
+  assert(load_error("test_bad.topo", "nodes 3\ndirected\n0 1 1\n1 0 1\n0 1 2\n") ==
+         "test_bad.topo:5: link 0 -> 1 is listed twice");
+  assert(load_error("test_bad.topo", "nodes 3\n\n0 1 -1\n").find(":3: expected a positive capacity") != string::npos);
+  assert(load_error("test_bad.topo", "nodes 3\n0 1 1 2\n").find(":2: unexpected '2'") != string::npos);
+  assert(load_error("test_bad.topo", "0 1 1\nnodes 3\n").find(":1: link before the nodes") != string::npos);
+  assert(load_error("test_bad.topo", "nodes 99999999999\n").find(":1: expected a positive node count") != string::npos);
+  assert(load_error("test_bad.graphml", "<graphml>\n<!-- open").find("test_bad.graphml:2: unterminated comment") == 0);
+  assert(load_error("test_bad.graphml", "<graphml>\n<node id=\"a").find(":2: unexpected end of file") != string::npos);
+  assert(load_error("test_bad.graphml", (string(speed_key) + "<edge source=\"a\" target=\"b\">"
+         "<data key=\"d1\">fast</data></edge></graph></graphml>").c_str()).find(":2: expected a non-negative link speed") != string::npos);
+  assert(load_error("test_bad.graphml", "<graphml><graph><edge target=\"b\"/></graph></graphml>").find("missing source") != string::npos);
+
+  // Links of the bundled topologies go both ways.
+  topo = BuildTopologyANS();
+  assert(topo->GetName() == "ANS" && topo->GetNodes().size() == 18 && topo->GetEdges().size() == 50);
+  assert(topo->GetEdge(topo->GetNode(17), topo->GetNode(15))->GetCap() == 1.0);
+  delete topo;
+}
+
+// Whether every node can reach every other one, the links of the tested topologies go both ways.
+bool IsConnected(Topology* topo) {
+  const CSRGraph& csr = topo->GetCSR();
+  vector<bool> seen(csr.NumNodes(), false);
+  vector<int> stack = {0};
+  seen[0] = true;
+  int reached = 1;
+  while(!stack.empty()) {
+    const int node = stack.back();
+    stack.pop_back();
+    for(int index = csr.offsets[node]; index < csr.offsets[node + 1]; index++) {
+      if(!seen[csr.adj_nodes[index]]) {
+        seen[csr.adj_nodes[index]] = true;
+        stack.push_back(csr.adj_nodes[index]);
+        reached++;
+      }
+    }
+  }
+  return reached == csr.NumNodes();
+}
+
+void TestTopologyGenerators() {
+  cout << endl << "TestTopologyGenerators" << endl;
+  // 4-ary fat-tree: 4 core, 8 aggregation and 8 edge switches of 4 ports, 16 hosts.
+  Topology* topo = BuildFatTree(4);
+  assert(topo->GetNodes().size() == 36 && topo->GetEdges().size() == 96 && IsConnected(topo));
+  for(Node* const node : topo->GetNodes()) {
+    assert(topo->GetAdjList(node).size() == (node->GetID() < 20 ? 4 : 1));
+  }
+  delete topo;
+  topo = BuildFatTree(4, false);
+  assert(topo->GetNodes().size() == 20 && topo->GetEdges().size() == 64 && IsConnected(topo));
+  delete topo;
+
+  // Jellyfish: every switch uses all of its ports on distinct neighbors, the seed fixes the graph.
+  topo = BuildJellyfish(50, 6, 7);
+  Topology* same = BuildJellyfish(50, 6, 7);
+  assert(topo->GetEdges().size() == 50 * 6 && IsConnected(topo));
+  for(Node* const node : topo->GetNodes()) {
+    unordered_set<Node*> neighbors;
+    for(const pair<Edge*, Node*>& next : topo->GetAdjList(node)) {
+      assert(next.second != node && neighbors.insert(next.second).second);
+    }
+    assert(neighbors.size() == 6);
+  }
+  for(int id = 0; id < topo->GetEdges().size(); id++) {
+    assert(topo->GetEdges()[id]->GetSrc()->GetID() == same->GetEdges()[id]->GetSrc()->GetID());
+    assert(topo->GetEdges()[id]->GetDst()->GetID() == same->GetEdges()[id]->GetDst()->GetID());
+  }
+  delete same;
+  delete topo;
+
+  // Random geometric WAN: connected, capacities from the tiers, the seed fixes the graph.
+  topo = BuildGeometricWAN(500, 3.0, 11);
+  same = BuildGeometricWAN(500, 3.0, 11);
+  assert(topo->GetNodes().size() == 500 && IsConnected(topo));
+  assert(topo->GetEdges().size() == same->GetEdges().size());
+  for(Edge* const edge : topo->GetEdges()) {
+    assert(find(begin(GEOMETRIC_WAN_CAPACITIES), end(GEOMETRIC_WAN_CAPACITIES), edge->GetCap()) !=
+           end(GEOMETRIC_WAN_CAPACITIES));
+    assert(same->GetEdges()[edge->GetID()]->GetCap() == edge->GetCap());
+  }
+  cout << topo->GetName() << ": " << topo->GetEdges().size() / 2 << " links" << endl;
+  delete same;
+  delete topo;
+}
+
+void TestRouteTable() {
+  cout << endl << "TestRouteTable" << endl;
+  Topology* topo = BuildGeometricWAN(300, 4.0, 5);
+  auto cost_func = [](Edge* edge) {
+    return 1.0 / edge->GetCap();
+  };
+  for(const RouteMetric metric : {RouteMetric::HOPS, RouteMetric::INVERSE_CAPACITY}) {
+    RouteTable& table = topo->GetRouteTable(metric);
+    assert(&topo->GetRouteTable(metric) == &table);
+    if(metric == RouteMetric::INVERSE_CAPACITY) {
+      table.Precompute(2);
+    }
+    Stochastic random(1.0, 1.0, Stochastic::DistributionTypes::DIST_EXPONENTIAL, 3);
+    for(int id = 0; id < 500; id++) {
+      const int src = random.genIndex(300);
+      const int dst = (src + 1 + random.genIndex(299)) % 300;
+      Flow flow(id, topo->GetNode(src), topo->GetNode(dst), 1.0);
+      const Path path = table.GetPath(src, dst, id);
+      const Path expected = (metric == RouteMetric::HOPS) ?
+        ComputeShortestPathGeneric(topo, &flow, [](Edge* edge) { return 1.0; }) :
+        ComputeShortestPathGeneric(topo, &flow, cost_func);
+      assert(path.GetFlow() == id && !path.GetEdges().empty() && path.GetEdges() == expected.GetEdges());
+    }
+  }
+  delete topo;
+  // Nothing reaches node 2.
+  topo = new Topology(3);
+  topo->AddBidirectionalEdge(topo->GetNode(0), topo->GetNode(1), 1.0);
+  RouteTable& table = topo->GetRouteTable(RouteMetric::HOPS);
+  assert(table.GetPath(0, 1, 0).GetEdges().size() == 1);
+  assert(table.GetPath(0, 2, 0).GetEdges().empty());
+  delete topo;
+}
+
+void TestUnroutableFlows() {
+  cout << endl << "TestUnroutableFlows" << endl;
+  // Two islands, {0, 1} and {2, 3}.
+  Topology* topo = new Topology(4);
+  topo->AddBidirectionalEdge(topo->GetNode(0), topo->GetNode(1), 1.0);
+  topo->AddBidirectionalEdge(topo->GetNode(2), topo->GetNode(3), 1.0);
+  vector<unique_ptr<FlowRouter> > routers;
+  routers.emplace_back(new ShortestPathRouter(topo, ShortestPathRouter::TECHNIQUE::BY_HOPS));
+  routers.emplace_back(new ShortestPathRouter(topo, ShortestPathRouter::TECHNIQUE::BY_INVERSE_CAPACITY));
+  routers.emplace_back(new BWRRouter(topo, BWRRouter::TECHNIQUE::BWROPT));
+  routers.emplace_back(new BWRRouter(topo, BWRRouter::TECHNIQUE::BWRHF_K_PRUNE));
+  for(unique_ptr<FlowRouter>& router : routers) {
+    router->PostFlows({Flow(0, topo->GetNode(0), topo->GetNode(3), 1.0), Flow(1, topo->GetNode(2), topo->GetNode(3), 2.0)});
+    assert(router->GetUnroutableFlows() == 1 && router->getRemainingFlows() == 1);
+    while(router->getRemainingFlows() > 0) {
+      router->NextEvent(numeric_limits<double>::infinity());
+    }
+    assert(router->getEpoch() == 2.0 && router->GetCompletionTimes().Count() == 1);
+    // The last flow to arrive has no path and nothing else is left, there is nothing to wait for.
+    router->NextEvent(5.0);
+    router->PostFlow(Flow(2, topo->GetNode(0), topo->GetNode(3), 1.0, 5.0));
+    assert(router->GetUnroutableFlows() == 2 && router->getRemainingFlows() == 0);
+    router->NextEvent(numeric_limits<double>::infinity());
+    assert(router->getEpoch() == 5.0 && router->GetCompletionTimes().Count() == 1);
+  }
+  routers.clear();
+  delete topo;
+}
+
+void TestEdgeAggregates() {
+  cout << endl << "TestEdgeAggregates" << endl;
+  // Node 0 reaches node 2 over 1 -> 2 or 1 -> 3 -> 2.
+  Topology* topo = new Topology(4);
+  topo->AddBidirectionalEdge(topo->GetNode(0), topo->GetNode(1), 1.0);
+  topo->AddBidirectionalEdge(topo->GetNode(1), topo->GetNode(2), 1.0);
+  topo->AddBidirectionalEdge(topo->GetNode(1), topo->GetNode(3), 1.0);
+  topo->AddBidirectionalEdge(topo->GetNode(3), topo->GetNode(2), 1.0);
+  auto edge = [topo](int src, int dst) {
+    for(Edge* const edge : topo->GetEdges()) {
+      if(edge->GetSrc()->GetID() == src && edge->GetDst()->GetID() == dst) {
+        return edge;
+      }
+    }
+    assert(false);
+    return static_cast<Edge*>(NULL);
+  };
+  // Splits every flow over both paths, which share the first edge.
+  class SplitRouter : public FlowRouter {
+  public:
+    SplitRouter(Topology* topo, const vector<vector<Edge*> >& paths) : FlowRouter(topo), paths_(paths) {}
+  protected:
+    void RouteFlow(Flow* new_flow) override {
+      for(const vector<Edge*>& edges : paths_) {
+        Path path(new_flow->GetID());
+        for(Edge* const edge : edges) {
+          path.AddEdge(edge);
+        }
+        InstallPath(new_flow, path);
+      }
+    }
+  private:
+    const vector<vector<Edge*> > paths_;
+  };
+  SplitRouter router(topo, {{edge(0, 1), edge(1, 2)}, {edge(0, 1), edge(1, 3), edge(3, 2)}});
+  router.PostFlow(Flow(0, topo->GetNode(0), topo->GetNode(2), 2.0));
+  assert(router.GetEdgeActiveFlows(edge(0, 1)) == 1 && router.GetEdgeActiveFlows(edge(1, 2)) == 1);
+  assert(router.GetEdgeActiveFlows(edge(3, 2)) == 1 && router.GetEdgeActiveFlows(edge(1, 0)) == 0);
+  // The remaining demand counts the flow once per path.
+  assert(router.GetEdgeRemainingDemand(edge(0, 1)) == 4.0 && router.GetEdgeRemainingDemand(edge(1, 2)) == 2.0);
+  router.PostFlow(Flow(1, topo->GetNode(0), topo->GetNode(2), 1.0));
+  assert(router.GetEdgeActiveFlows(edge(0, 1)) == 2 && router.GetEdgeActiveFlows(edge(1, 3)) == 2);
+  router.NextEvent(numeric_limits<double>::infinity());
+  assert(router.getRemainingFlows() == 1);
+  assert(router.GetEdgeActiveFlows(edge(0, 1)) == 1 && router.GetEdgeActiveFlows(edge(1, 3)) == 1);
+  while(router.getRemainingFlows() > 0) {
+    router.NextEvent(numeric_limits<double>::infinity());
+  }
+  for(Edge* const edge : topo->GetEdges()) {
+    assert(router.GetEdgeActiveFlows(edge) == 0 && router.GetEdgeRemainingDemand(edge) == 0.0);
+  }
+  delete topo;
+}
+
 void RunAllTests() {
   cout << "Running All Tests..." << endl;
 
@@ -409,6 +1026,16 @@ void RunAllTests() {
   // Test the RouteFlow function from the parent class.
   bwr_router_test2.RunTests();
 
+  // BWRRouter Test (multipath)
+  BWRRouterTest bwr_router_test3(test_topo, BWRRouter::TECHNIQUE::BWRHF_K);
+  // Test the RouteFlow function from the parent class.
+  bwr_router_test3.RunTests();
+
+  // BWRRouter Test (multipath with pruning)
+  BWRRouterTest bwr_router_test4(test_topo, BWRRouter::TECHNIQUE::BWRHF_K_PRUNE);
+  // Test the RouteFlow function from the parent class.
+  bwr_router_test4.RunTests();
+
   // ShortestPathRouter Test
   ShortestPathRouterTest shortest_path_router_test(test_topo, ShortestPathRouter::TECHNIQUE::BY_HOPS);
   // Test the RouteFlow function from the parent class.
@@ -427,11 +1054,56 @@ void RunAllTests() {
   // Delete topology.
   delete test_topo;
 
+  // Max-min fair rate allocation.
+  TestWaterFilling();
+
+  // Compressed-sparse-row view of the topology.
+  TestTopologyCSR();
+
+  // Edge-list and GraphML topology files.
+  TestTopologyLoader();
+
+  // Seeded synthetic topologies.
+  TestTopologyGenerators();
+
+  // Route tables shared by the shortest path routers.
+  TestRouteTable();
+
+  // Flows whose destination cannot be reached.
+  TestUnroutableFlows();
+
+  // Per-edge remaining demand and active flow counts.
+  TestEdgeAggregates();
+
   // Generate some random flows.
   TestDistribution(Stochastic::DistributionTypes::DIST_EXPONENTIAL);
   TestDistribution(Stochastic::DistributionTypes::DIST_PARETO);
   TestDistribution(Stochastic::DistributionTypes::DIST_FB_CF);
   TestDistribution(Stochastic::DistributionTypes::DIST_FB_HADOOP);
+
+  // Seeded, per-instance random streams.
+  TestStochasticSeeding();
+
+  // Binary trace files.
+  TestTrace();
+
+  // Binary per-flow results.
+  TestFlowRecords();
+
+  // Slab storage of flows and paths.
+  TestObjectPool();
+
+  // Exceptions thrown by parallel jobs.
+  TestThreadPool();
+
+  // Progress kernels over structure-of-arrays flow state.
+  TestFlowProgress();
+
+  // Attribution of the hot-path counters.
+  TestInstrumentation();
+
+  // Streaming summaries of completion times.
+  TestQuantileSketch();
 }
 
 } // namespace Network
\ No newline at end of file
@@ -9,10 +9,22 @@
 #include <functional>
 
 #include "topology.hpp"
+#include "topology_loader.hpp"
+#include "topologies.hpp"
+#include "topology_generators.hpp"
 #include "bwr_router.hpp"
+#include "flow_progress.hpp"
+#include "flow_records.hpp"
+#include "instrumentation.hpp"
+#include "object_pool.hpp"
+#include "quantile_sketch.hpp"
+#include "route_table.hpp"
 #include "shortest_path_router.hpp"
 #include "utilization_router.hpp"
 #include "stochastic.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include "water_filling.hpp"
 
 using namespace std;
 
@@ -44,6 +56,36 @@ Topology* BuildTopology();
 
 void TestDistribution(Stochastic::DistributionTypes dist_type);
 
+void TestStochasticSeeding();
+
+void TestTrace();
+
+void TestFlowRecords();
+
+void TestObjectPool();
+
+void TestThreadPool();
+
+void TestFlowProgress();
+
+void TestInstrumentation();
+
+void TestQuantileSketch();
+
+void TestWaterFilling();
+
+void TestTopologyCSR();
+
+void TestTopologyLoader();
+
+void TestTopologyGenerators();
+
+void TestRouteTable();
+
+void TestUnroutableFlows();
+
+void TestEdgeAggregates();
+
 void RunAllTests();
 
 } // namespace Network
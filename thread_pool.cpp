@@ -0,0 +1,106 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <cassert>
+
+#include "thread_pool.hpp"
+
+using namespace std;
+
+namespace Network {
+
+ThreadPool::ThreadPool(int threads) : body_(NULL), jobs_(0), next_job_(0), 
+                                      pending_workers_(0), generation_(0), stop_(false) {
+  if(threads <= 0) {
+    threads = max(1u, thread::hardware_concurrency());
+  }
+  // The thread calling ParallelFor is one of the threads.
+  for(int index = 1; index < threads; index++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for(thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::GetThreads() const {
+  return workers_.size() + 1;
+}
+
+void ThreadPool::RunJobs() {
+  for(int job = next_job_++; job < jobs_; job = next_job_++) {
+    try {
+      (*body_)(job);
+    } catch(...) {
+      lock_guard<mutex> lock(mutex_);
+      if(!error_) {
+        error_ = current_exception();
+      }
+      // Nobody takes another job of this batch.
+      next_job_ = jobs_;
+      return;
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  long seen_generation = 0;
+  for(;;) {
+    {
+      unique_lock<mutex> lock(mutex_);
+      wake_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+      if(stop_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+    RunJobs();
+    {
+      lock_guard<mutex> lock(mutex_);
+      pending_workers_--;
+    }
+    done_.notify_one();
+  }
+}
+
+void ThreadPool::ParallelFor(int jobs, const function<void(int)>& body) {
+  if(workers_.empty() || jobs <= 1) {
+    for(int job = 0; job < jobs; job++) {
+      body(job);
+    }
+    return;
+  }
+  {
+    lock_guard<mutex> lock(mutex_);
+    assert(pending_workers_ == 0);
+    body_ = &body;
+    jobs_ = jobs;
+    next_job_ = 0;
+    pending_workers_ = workers_.size();
+    generation_++;
+  }
+  wake_.notify_all();
+  RunJobs();
+  // Every worker takes part in every batch, so none of them can still be in this one
+  // once the count drops to zero.
+  unique_lock<mutex> lock(mutex_);
+  done_.wait(lock, [&]() { return pending_workers_ == 0; });
+  body_ = NULL;
+  if(error_) {
+    exception_ptr error = error_;
+    error_ = NULL;
+    lock.unlock();
+    rethrow_exception(error);
+  }
+}
+
+} // namespace Network
@@ -0,0 +1,49 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace Network {
+
+// Fixed set of worker threads that run batches of independent jobs. The workers are
+// started once and sleep between batches. A pool must not be used from its own jobs.
+class ThreadPool {
+public:
+  // Zero or less means one thread per hardware thread.
+  explicit ThreadPool(int threads);
+  ~ThreadPool();
+  int GetThreads() const;
+  // Call body(0), ..., body(jobs - 1) across the pool (the calling thread helps) and wait
+  // until all of them have returned. Jobs are handed out in index order. If a job throws,
+  // no more jobs are started and the first exception is rethrown once the others are done.
+  void ParallelFor(int jobs, const function<void(int)>& body);
+private:
+  void WorkerLoop();
+  void RunJobs();
+  vector<thread> workers_;
+  mutex mutex_;
+  condition_variable wake_, done_;
+  const function<void(int)>* body_;
+  int jobs_;
+  atomic<int> next_job_;
+  int pending_workers_; // Workers that have not finished the current batch.
+  exception_ptr error_; // First exception thrown by a job of the current batch.
+  long generation_;     // Bumped for every batch.
+  bool stop_;
+};
+
+} // namespace Network
+
+#endif // THREAD_POOL_HPP
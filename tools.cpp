@@ -2,7 +2,6 @@
 // Copyright 2019
 // Can be distributed under MIT license (https://opensource.org/licenses/MIT)
 
-#include <queue>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -23,7 +22,8 @@ Path::Path(int flow_id) : flow_id_(flow_id), bottleneck_cap_(numeric_limits<doub
 
 void Path::AddEdge(Edge* edge) {
   edges_.push_back(edge);
-  edges_hashset_.insert(edge);
+  // Paths are a handful of hops, an insertion keeps the ids sorted.
+  edge_ids_.insert(upper_bound(edge_ids_.begin(), edge_ids_.end(), edge->GetID()), edge->GetID());
   bottleneck_cap_ = min(bottleneck_cap_, edge->GetCap());
 }
 
@@ -31,8 +31,12 @@ const vector<Edge*>& Path::GetEdges() const {
   return edges_;
 }
 
-const unordered_set<Edge*>& Path::GetEdgesSet() const {
-  return edges_hashset_;
+const vector<int>& Path::GetEdgeIDs() const {
+  return edge_ids_;
+}
+
+bool Path::Contains(Edge* edge) const {
+  return binary_search(edge_ids_.begin(), edge_ids_.end(), edge->GetID());
 }
 
 double Path::GetBottleneckCap() {
@@ -44,15 +48,15 @@ const int Path::GetFlow() const {
 }
 
 bool Path::operator==(const Path& path) {
-  return (edges_hashset_ == path.GetEdgesSet()) && (flow_id_ == path.GetFlow());
+  return (edge_ids_ == path.GetEdgeIDs()) && (flow_id_ == path.GetFlow());
 }
 
 bool operator==(const Path& path1, const Path& path2) {
-  return (path1.GetEdgesSet() == path2.GetEdgesSet()) && (path1.GetFlow() == path2.GetFlow());
+  return (path1.GetEdgeIDs() == path2.GetEdgeIDs()) && (path1.GetFlow() == path2.GetFlow());
 }
 
-Flow::Flow(int id, Node* const src, Node* const dst, double size) : 
-           id_(id), src_(src), dst_(dst), size_(size), completed_(0.0) {}
+Flow::Flow(int id, Node* const src, Node* const dst, double size, double arrival) : 
+           id_(id), src_(src), dst_(dst), size_(size), arrival_(arrival), completed_(0.0) {}
 
 void Flow::AddPath(Path* path) {
   paths_.push_back(path);
@@ -70,6 +74,22 @@ void Flow::AddCompleted(double completed) {
   completed_ += completed;
 }
 
+double Flow::GetArrival() const {
+  return arrival_;
+}
+
+double Flow::GetSize() const {
+  return size_;
+}
+
+double Flow::GetCompleted() const {
+  return completed_;
+}
+
+void Flow::SetCompleted(double completed) {
+  completed_ = completed;
+}
+
 Node* Flow::GetSrc() {
   return src_;
 }
@@ -82,65 +102,31 @@ int Flow::GetID() {
   return id_;
 }
 
-namespace {
-  struct DijkPath {
-    vector<Node*> path;
-    unordered_set<Node*> visited;
-    double weight;
-    // Constructor.
-    DijkPath(vector<Node*> path_, double weight_) : 
-             path(move(path_)), weight(weight_) {
-      for(Node* const node : path) {
-        visited.insert(node);
-      }
-    }
-  };
-
-  using DijkComp = function<bool(const DijkPath&, const DijkPath&)>;
-}
-
-Path ComputeShortestPathGeneric(Topology* topo, Flow* new_flow, function<double(Edge*)> cost_func) {
-  Node* const src = new_flow->GetSrc();
-  Node* const dst = new_flow->GetDst();
-
-  priority_queue<DijkPath, vector<DijkPath>, DijkComp> pq(
-    [&](const DijkPath& path1, const DijkPath& path2) {
-      return path1.weight > path2.weight;
-  });
-  pq.push(DijkPath({src}, 0.0));
-
-  DijkPath sol({src}, 0.0);
-  unordered_map<Node*, double> num_paths_by_node;
-
-  while(!pq.empty()) {
-    DijkPath current = pq.top();
-    pq.pop();
-    num_paths_by_node[current.path.back()]++;
-    // End condition to be checked here ------------------
-    if(current.path.back() == dst) {
-      sol = current;
-      break;
-    }
-    if(num_paths_by_node[current.path.back()] > 1) {
-      continue;
-    }
-    // Update the heap.
-    for(const pair<Edge* const, Node*>& next : topo->GetAdjList(current.path.back())) {
-      if(current.visited.find(next.second) == current.visited.end()) {
-        DijkPath new_path = current;
-        new_path.path.push_back(next.second);
-        new_path.visited.insert(next.second);
-        const double edge_cost = cost_func(next.first);
-        assert(numeric_limits<double>::max() - edge_cost > new_path.weight);
-        assert(numeric_limits<double>::max() - new_path.weight > edge_cost);
-        new_path.weight += edge_cost;
-        pq.push(new_path);
-      }
-    }
+void DijkstraSearch::Reset(int nodes) {
+  if(reached_.size() < nodes) {
+    reached_.resize(nodes, 0);
+    dist_.resize(nodes);
+    pred_edge_.resize(nodes);
   }
+  heap_.Resize(nodes);
+  stamp_++;
+}
+
+// Walk the predecessor edges back from the destination.
+Path DijkstraSearch::BuildPath(Topology* topo, Flow* new_flow) {
   Path new_path(new_flow->GetID());
-  for(int i = 1; i < sol.path.size(); i++) {
-    new_path.AddEdge(topo->GetEdge(sol.path[i-1], sol.path[i]));
+  const int src = new_flow->GetSrc()->GetID();
+  const int dst = new_flow->GetDst()->GetID();
+  if(reached_[dst] != stamp_) {
+    return new_path;
+  }
+  const CSRGraph& csr = topo->GetCSR();
+  reversed_path_.clear();
+  for(int node = dst; node != src; node = csr.edge_src[pred_edge_[node]]) {
+    reversed_path_.push_back(pred_edge_[node]);
+  }
+  for(auto it = reversed_path_.rbegin(); it != reversed_path_.rend(); it++) {
+    new_path.AddEdge(topo->GetEdges()[*it]);
   }
   return new_path;
 }
@@ -5,10 +5,15 @@
 #ifndef TOOLS_HPP
 #define TOOLS_HPP
 
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <unordered_set>
 #include <vector>
 #include <functional>
 
+#include "indexed_heap.hpp"
+#include "instrumentation.hpp"
 #include "topology.hpp"
 
 using namespace std;
@@ -19,15 +24,18 @@ class Path {
 public:
   explicit Path(int flow_id);
   void AddEdge(Edge* edge);
+  // Edges in path order.
   const vector<Edge*>& GetEdges() const;
-  const unordered_set<Edge*>& GetEdgesSet() const;
+  // Ids of the edges in increasing order, for membership tests and intersections.
+  const vector<int>& GetEdgeIDs() const;
+  bool Contains(Edge* edge) const;
   double GetBottleneckCap();
   bool operator==(const Path& path);
   const int GetFlow() const;
 private:
   int flow_id_;
   vector<Edge*> edges_;
-  unordered_set<Edge*> edges_hashset_;
+  vector<int> edge_ids_; // Sorted.
   double bottleneck_cap_;
 };
 
@@ -35,25 +43,126 @@ bool operator==(const Path& path1, const Path& path2);
 
 class Flow {
 public:
-  Flow(int id, Node* const src, Node* const dst, double size);
+  Flow(int id, Node* const src, Node* const dst, double size, double arrival = 0.0);
   void AddPath(Path* path);
   const vector<Path*>& GetPaths();
   double GetRemainingSize() const;
   void AddCompleted(double completed);
+  double GetSize() const;
+  double GetCompleted() const;
+  void SetCompleted(double completed);
   Node* GetSrc();
   Node* GetDst();
   int GetID();
+  double GetArrival() const;
 private:
   int id_;
   double size_;
-  Node* const src_;
-  Node* const dst_;
+  double arrival_;
+  Node* src_;
+  Node* dst_;
   double completed_;
   vector<Path*> paths_;
 };
 
-// Generic shortest path function, can be used by anyone
-Path ComputeShortestPathGeneric(Topology* topo, Flow* new_flow, function<double(Edge*)> cost_func);
+// Label-setting Dijkstra over the CSR view of a topology. The distance and predecessor
+// arrays and the heap are kept across searches, entries from older searches are told
+// apart by a per-search stamp so nothing is cleared in between.
+class DijkstraSearch {
+public:
+  DijkstraSearch() : stamp_(0) {}
+  // Shortest path of the flow from its source to its destination where cost_func(Edge*)
+  // gives the (non-negative) cost of every edge, an infinite cost excludes the edge.
+  // Empty if the destination is unreachable.
+  template<typename CostFunc>
+  Path FindPath(Topology* topo, Flow* new_flow, CostFunc& cost_func);
+  // Shortest path tree from src: pred_edges[n] is the id of the last edge on the shortest
+  // path to node n, -1 for src and the nodes it does not reach. A path found by FindPath
+  // is the path to its destination in the tree of its source.
+  template<typename CostFunc>
+  void FindTree(Topology* topo, int src, CostFunc& cost_func, vector<int>& pred_edges);
+private:
+  // Settle nodes from src until dst is settled or, if dst is -1, every reachable node is.
+  template<typename CostFunc>
+  void Search(Topology* topo, int src, int dst, CostFunc& cost_func);
+  void Reset(int nodes);
+  Path BuildPath(Topology* topo, Flow* new_flow);
+  int stamp_;
+  vector<int> reached_; // Stamp of the last search that reached a node.
+  vector<double> dist_;
+  vector<int> pred_edge_;
+  vector<int> reversed_path_;
+  IndexedHeap<> heap_;
+};
+
+template<typename CostFunc>
+Path DijkstraSearch::FindPath(Topology* topo, Flow* new_flow, CostFunc& cost_func) {
+  Search(topo, new_flow->GetSrc()->GetID(), new_flow->GetDst()->GetID(), cost_func);
+  return BuildPath(topo, new_flow);
+}
+
+template<typename CostFunc>
+void DijkstraSearch::FindTree(Topology* topo, int src, CostFunc& cost_func, vector<int>& pred_edges) {
+  Search(topo, src, -1, cost_func);
+  const int nodes = topo->GetCSR().NumNodes();
+  pred_edges.resize(nodes);
+  for(int node = 0; node < nodes; node++) {
+    pred_edges[node] = (reached_[node] == stamp_) ? pred_edge_[node] : -1;
+  }
+}
+
+template<typename CostFunc>
+void DijkstraSearch::Search(Topology* topo, int src, int dst, CostFunc& cost_func) {
+  const CSRGraph& csr = topo->GetCSR();
+  const vector<Edge*>& edges = topo->GetEdges();
+  Reset(csr.NumNodes());
+  reached_[src] = stamp_;
+  dist_[src] = 0.0;
+  pred_edge_[src] = -1;
+  heap_.PushOrDecrease(src, 0.0);
+  uint64_t pushes = 1, pops = 0;
+  while(!heap_.Empty()) {
+    const int node = heap_.PopMin();
+    pops++;
+    if(node == dst) {
+      break;
+    }
+    for(int index = csr.offsets[node]; index < csr.offsets[node + 1]; index++) {
+      const int next = csr.adj_nodes[index];
+      const bool reached = (reached_[next] == stamp_);
+      // Settled nodes are reached but no longer in the heap.
+      if(reached && !heap_.Contains(next)) {
+        continue;
+      }
+      const int edge_id = csr.adj_edges[index];
+      const double edge_cost = cost_func(edges[edge_id]);
+      if(isinf(edge_cost)) {
+        continue;
+      }
+      assert(numeric_limits<double>::max() - edge_cost > dist_[node]);
+      assert(numeric_limits<double>::max() - dist_[node] > edge_cost);
+      const double weight = dist_[node] + edge_cost;
+      if(!reached || weight < dist_[next]) {
+        reached_[next] = stamp_;
+        dist_[next] = weight;
+        pred_edge_[next] = edge_id;
+        heap_.PushOrDecrease(next, weight);
+        pushes++;
+      }
+    }
+  }
+  heap_.Clear();
+  Count(Counter::HEAP_PUSHES, pushes);
+  Count(Counter::HEAP_POPS, pops);
+}
+
+// Generic shortest path function, can be used by anyone. The cost functor is called
+// once per explored edge and is inlined into the search.
+template<typename CostFunc>
+Path ComputeShortestPathGeneric(Topology* topo, Flow* new_flow, CostFunc cost_func) {
+  static thread_local DijkstraSearch search;
+  return search.FindPath(topo, new_flow, cost_func);
+}
 
 } // namespace Network
 
@@ -2,11 +2,13 @@
 // Copyright 2019
 // Can be distributed under MIT license (https://opensource.org/licenses/MIT)
 
+#include <cassert>
 #include <vector>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "route_table.hpp"
 #include "topology.hpp"
 
 using namespace std;
@@ -20,7 +22,11 @@ int Node::GetID() {
 }
 
 // Class "Edge" methods.
-Edge::Edge(Node* src, Node* dst, double capacity) : src_(src), dst_(dst), capacity_(capacity) {}
+Edge::Edge(int id, Node* src, Node* dst, double capacity) : id_(id), src_(src), dst_(dst), capacity_(capacity) {}
+
+int Edge::GetID() {
+  return id_;
+}
 
 Node* Edge::GetSrc() {
   return src_;
@@ -37,17 +43,25 @@ double Edge::GetCap() {
 // Class "Topology" methods.
 Topology::Topology(int nodes) : Topology(nodes, "") {}
 
-Topology::Topology(int nodes, string name) : name_(name) {
+Topology::Topology(int nodes, string name) : name_(name), adjlist_(nodes), frozen_(false) {
+  node_storage_.reserve(nodes);
   for(int id = 0; id < nodes; id++) {
-    nodes_.push_back(new Node(id));
+    node_storage_.emplace_back(id);
+    nodes_.push_back(&node_storage_.back());
   }
 }
 
+long long Topology::EdgeKey(int src, int dst) {
+  return static_cast<long long>(src) * nodes_.size() + dst;
+}
+
 void Topology::AddEdge(Node* src, Node* dst, double capacity) {
-  Edge* edge = new Edge(src, dst, capacity);
+  assert(!frozen_);
+  edge_storage_.emplace_back(edges_.size(), src, dst, capacity);
+  Edge* edge = &edge_storage_.back();
   edges_.push_back(edge);
-  adjlist_[src].push_back(make_pair(edge, dst));
-  edgelookup_[make_pair(src, dst)] = edge;
+  adjlist_[src->GetID()].push_back(make_pair(edge, dst));
+  edgelookup_[EdgeKey(src->GetID(), dst->GetID())] = edge->GetID();
 }
 
 void Topology::AddBidirectionalEdge(Node* src, Node* dst, double capacity) {
@@ -55,6 +69,11 @@ void Topology::AddBidirectionalEdge(Node* src, Node* dst, double capacity) {
   AddEdge(dst, src, capacity);
 }
 
+void Topology::ReserveEdges(int edges) {
+  edges_.reserve(edges);
+  edgelookup_.reserve(edges);
+}
+
 const vector<Node*>& Topology::GetNodes() {
   return nodes_;
 }
@@ -64,7 +83,7 @@ const vector<Edge*>& Topology::GetEdges() {
 }
 
 const vector< pair< Edge*, Node*> >& Topology::GetAdjList(Node* node) {
-  return adjlist_[node];
+  return adjlist_[node->GetID()];
 }
 
 Node* Topology::GetNode(int id) {
@@ -72,20 +91,53 @@ Node* Topology::GetNode(int id) {
 }
 
 Edge* Topology::GetEdge(Node* src, Node* dst) {
-  return edgelookup_[make_pair(src, dst)];
+  const int id = GetEdgeID(src->GetID(), dst->GetID());
+  return (id < 0) ? NULL : edges_[id];
+}
+
+int Topology::GetEdgeID(int src, int dst) {
+  auto it = edgelookup_.find(EdgeKey(src, dst));
+  return (it == edgelookup_.end()) ? -1 : it->second;
 }
 
 string Topology::GetName() {
   return name_;
 }
 
-Topology::~Topology() {
-  for(Edge*& edge : edges_) {
-    delete edge;
+const CSRGraph& Topology::GetCSR() {
+  if(frozen_) {
+    return csr_;
+  }
+  frozen_ = true;
+  csr_.offsets.assign(1, 0);
+  for(int id = 0; id < nodes_.size(); id++) {
+    for(pair<Edge*, Node*>& next : adjlist_[id]) {
+      csr_.adj_edges.push_back(next.first->GetID());
+      csr_.adj_nodes.push_back(next.second->GetID());
+    }
+    csr_.offsets.push_back(csr_.adj_edges.size());
   }
-  for(Node*& node : nodes_) {
-    delete node;
+  for(Edge* const edge : edges_) {
+    csr_.capacities.push_back(edge->GetCap());
+    csr_.edge_src.push_back(edge->GetSrc()->GetID());
+    csr_.edge_dst.push_back(edge->GetDst()->GetID());
+  }
+  return csr_;
+}
+
+bool Topology::IsFrozen() {
+  return frozen_;
+}
+
+RouteTable& Topology::GetRouteTable(RouteMetric metric) {
+  lock_guard<mutex> lock(route_tables_mutex_);
+  unique_ptr<RouteTable>& table = route_tables_[metric];
+  if(table == NULL) {
+    table.reset(new RouteTable(this, metric));
   }
+  return *table;
 }
 
-} // namespace Network
\ No newline at end of file
+Topology::~Topology() {}
+
+} // namespace Network
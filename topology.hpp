@@ -5,6 +5,9 @@
 #ifndef TOPOLOGY_HPP
 #define TOPOLOGY_HPP
 
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -15,6 +18,9 @@ using namespace std;
 
 namespace Network {
 
+class RouteTable;         // See route_table.hpp.
+enum class RouteMetric : int;
+
 class Node {
 public:
   explicit Node(int id);
@@ -25,15 +31,32 @@ private:
 
 class Edge {
 public:
-  Edge(Node* src, Node* dst, double capacity);
+  Edge(int id, Node* src, Node* dst, double capacity);
+  int GetID();
   Node* GetSrc();
   Node* GetDst();
   double GetCap();
 private:
+  int id_; // Edges are numbered in the order they are added to the topology.
   Node *src_, *dst_;
   double capacity_;
 };
 
+// Compressed-sparse-row view of a topology where nodes and edges are referred to by id.
+// The edges leaving node n are adj_edges[offsets[n]] ... adj_edges[offsets[n+1]-1] and
+// adj_nodes holds the node at the other end of each of them.
+struct CSRGraph {
+  vector<int> offsets;
+  vector<int> adj_edges;
+  vector<int> adj_nodes;
+  // Indexed by edge id.
+  vector<double> capacities;
+  vector<int> edge_src;
+  vector<int> edge_dst;
+  int NumNodes() const { return offsets.size() - 1; }
+  int NumEdges() const { return capacities.size(); }
+};
+
 // Represents a directed graph.
 class Topology {
 public:
@@ -42,18 +65,36 @@ public:
   ~Topology();
   void AddEdge(Node* src, Node* dst, double capacity);
   void AddBidirectionalEdge(Node* src, Node* dst, double capacity);
+  // Make room for this many edges in total, e.g. before loading a large topology.
+  void ReserveEdges(int edges);
   const vector<Node*>& GetNodes();
   const vector<Edge*>& GetEdges();
   const vector<pair<Edge*, Node*> >& GetAdjList(Node* node);
   Edge* GetEdge(Node* src, Node* dst);
+  // Id of the edge from src to dst or -1 if there is none.
+  int GetEdgeID(int src, int dst);
   Node* GetNode(int id);
   string GetName();
+  // Build the CSR view on first use. No edges can be added after that.
+  const CSRGraph& GetCSR();
+  bool IsFrozen();
+  // Shortest paths under a static edge cost, built on first use and shared by everyone
+  // using the topology (freezes it too). Safe to call from several threads.
+  RouteTable& GetRouteTable(RouteMetric metric);
 private:
+  long long EdgeKey(int src, int dst);
   const string name_;
-  unordered_map< Node*, vector< pair<Edge*, Node*> > > adjlist_; // Node to next <Edge, Node>
-  map<pair<Node*, Node*>, Edge*> edgelookup_; // node pair to edge in between
+  // Node and edge objects are stored contiguously, edges in a deque so that pointers stay valid.
+  vector<Node> node_storage_;
+  deque<Edge> edge_storage_;
+  vector< vector< pair<Edge*, Node*> > > adjlist_; // Node id to next <Edge, Node>
+  unordered_map<long long, int> edgelookup_; // node pair to id of the edge in between
   vector<Edge*> edges_;
   vector<Node*> nodes_;
+  CSRGraph csr_;
+  bool frozen_;
+  mutex route_tables_mutex_;
+  map<RouteMetric, unique_ptr<RouteTable> > route_tables_;
 };
 
 } // namespace Network
@@ -0,0 +1,292 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "stochastic.hpp"
+#include "topology_generators.hpp"
+
+namespace Network {
+
+namespace {
+
+// Consecutive failed attempts at linking two random switches before Jellyfish moves on to
+// splitting existing links, per switch that still has free ports (per port when splitting).
+constexpr int JELLYFISH_ATTEMPTS = 16;
+
+Topology* BuildFromLinks(int nodes, const string& name, const vector<pair<int, int> >& links,
+                         const vector<double>& capacities) {
+  Topology* topo = new Topology(nodes, name);
+  topo->ReserveEdges(2 * links.size());
+  for(size_t index = 0; index < links.size(); index++) {
+    topo->AddBidirectionalEdge(topo->GetNode(links[index].first), topo->GetNode(links[index].second),
+                               capacities[index]);
+  }
+  return topo;
+}
+
+// Union-find over node ids with path halving.
+class DisjointSets {
+public:
+  explicit DisjointSets(int size) : parent_(size) {
+    iota(parent_.begin(), parent_.end(), 0);
+  }
+  int Find(int x) {
+    while(parent_[x] != x) {
+      parent_[x] = parent_[parent_[x]];
+      x = parent_[x];
+    }
+    return x;
+  }
+  void Union(int a, int b) {
+    parent_[Find(a)] = Find(b);
+  }
+private:
+  vector<int> parent_;
+};
+
+} // namespace
+
+Topology* BuildFatTree(int k, bool hosts, double capacity) {
+  assert(k >= 2 && k % 2 == 0 && capacity > 0.0);
+  const int half = k / 2;
+  const int core = half * half;
+  const int switches = core + k * k;
+  const int nodes = switches + (hosts ? k * half * half : 0);
+  vector<pair<int, int> > links;
+  links.reserve(k * half * half * (hosts ? 3 : 2));
+  for(int pod = 0; pod < k; pod++) {
+    const int aggregation = core + pod * k;
+    const int edge = aggregation + half;
+    for(int i = 0; i < half; i++) {
+      // Aggregation switch i of every pod goes to core switches i * k/2 ... (i + 1) * k/2 - 1.
+      for(int j = 0; j < half; j++) {
+        links.push_back(make_pair(aggregation + i, i * half + j));
+      }
+    }
+    for(int i = 0; i < half; i++) {
+      for(int j = 0; j < half; j++) {
+        links.push_back(make_pair(edge + i, aggregation + j));
+      }
+    }
+    if(hosts) {
+      for(int i = 0; i < half; i++) {
+        const int first_host = switches + (pod * half + i) * half;
+        for(int j = 0; j < half; j++) {
+          links.push_back(make_pair(edge + i, first_host + j));
+        }
+      }
+    }
+  }
+  return BuildFromLinks(nodes, "FatTree_" + to_string(k), links, vector<double>(links.size(), capacity));
+}
+
+Topology* BuildJellyfish(int switches, int degree, uint64_t seed, double capacity) {
+  assert(degree > 0 && switches > degree && capacity > 0.0);
+  Stochastic random(1.0, 1.0, Stochastic::DistributionTypes::DIST_EXPONENTIAL, seed);
+  vector<int> free_ports(switches, degree);
+  // Switches with free ports and where each one is in that list.
+  vector<int> open(switches), position(switches);
+  iota(open.begin(), open.end(), 0);
+  iota(position.begin(), position.end(), 0);
+  vector<pair<int, int> > links;
+  links.reserve(static_cast<long long>(switches) * degree / 2);
+  unordered_set<long long> linked;
+  linked.reserve(links.capacity());
+  auto key = [switches](int a, int b) {
+    return static_cast<long long>(min(a, b)) * switches + max(a, b);
+  };
+  auto use_port = [&](int node) {
+    if(--free_ports[node] == 0) {
+      const int last = open.back();
+      open[position[node]] = last;
+      position[last] = position[node];
+      open.pop_back();
+    }
+  };
+  // Link random pairs of switches with free ports while there are pairs that are not linked yet.
+  int failures = 0;
+  while(open.size() >= 2 && failures < JELLYFISH_ATTEMPTS * static_cast<int>(open.size())) {
+    const int a = open[random.genIndex(open.size())];
+    const int b = open[random.genIndex(open.size())];
+    if(a == b || !linked.insert(key(a, b)).second) {
+      failures++;
+      continue;
+    }
+    failures = 0;
+    links.push_back(make_pair(a, b));
+    use_port(a);
+    use_port(b);
+  }
+  // Switches left with free ports take over random links instead, as in the original
+  // Jellyfish construction: (x, y) becomes (s, x), (t, y) where t is s itself if it has two
+  // free ports and another switch with a free port otherwise.
+  failures = 0;
+  while(!open.empty() && failures < JELLYFISH_ATTEMPTS * degree) {
+    const int s = open[0];
+    const int t = (free_ports[s] >= 2) ? s : ((open.size() >= 2) ? open[1] : -1);
+    if(t < 0) {
+      break;
+    }
+    const int index = random.genIndex(links.size());
+    const int x = links[index].first, y = links[index].second;
+    if(x == s || x == t || y == s || y == t || linked.count(key(s, x)) > 0 || linked.count(key(t, y)) > 0) {
+      failures++;
+      continue;
+    }
+    failures = 0;
+    linked.erase(key(x, y));
+    links[index] = make_pair(s, x);
+    links.push_back(make_pair(t, y));
+    linked.insert(key(s, x));
+    linked.insert(key(t, y));
+    use_port(s);
+    use_port(t);
+  }
+  return BuildFromLinks(switches, "Jellyfish_" + to_string(switches) + "_" + to_string(degree), links,
+                        vector<double>(links.size(), capacity));
+}
+
+Topology* BuildGeometricWAN(int nodes, double average_degree, uint64_t seed) {
+  assert(nodes >= 2 && average_degree > 0.0);
+  Stochastic random(1.0, 1.0, Stochastic::DistributionTypes::DIST_EXPONENTIAL, seed);
+  vector<double> x(nodes), y(nodes);
+  for(int node = 0; node < nodes; node++) {
+    x[node] = random.genRand();
+    y[node] = random.genRand();
+  }
+  // Expected degree of a node is nodes * pi * radius^2, ignoring the border.
+  const double pi = acos(-1.0);
+  const double radius = sqrt(average_degree / (pi * nodes));
+  // Square grid of cells no smaller than the radius, nodes bucketed by cell (counting sort).
+  const int cells = max(1, min(static_cast<int>(1.0 / radius), static_cast<int>(sqrt(nodes)) + 1));
+  const double cell_size = 1.0 / cells;
+  auto cell_of = [cells](double coordinate) {
+    return min(static_cast<int>(coordinate * cells), cells - 1);
+  };
+  vector<int> cell_offsets(cells * cells + 1, 0), cell_nodes(nodes);
+  for(int node = 0; node < nodes; node++) {
+    cell_offsets[cell_of(y[node]) * cells + cell_of(x[node]) + 1]++;
+  }
+  partial_sum(cell_offsets.begin(), cell_offsets.end(), cell_offsets.begin());
+  {
+    vector<int> fill(cell_offsets.begin(), cell_offsets.end() - 1);
+    for(int node = 0; node < nodes; node++) {
+      cell_nodes[fill[cell_of(y[node]) * cells + cell_of(x[node])]++] = node;
+    }
+  }
+  auto distance = [&x, &y](int a, int b) {
+    return hypot(x[a] - x[b], y[a] - y[b]);
+  };
+  auto draw_capacity = [&random]() {
+    double share = random.genRand();
+    for(int tier = 0; tier < GEOMETRIC_WAN_TIERS - 1; tier++) {
+      share -= GEOMETRIC_WAN_TIER_SHARES[tier];
+      if(share <= 0.0) {
+        return GEOMETRIC_WAN_CAPACITIES[tier];
+      }
+    }
+    return GEOMETRIC_WAN_CAPACITIES[GEOMETRIC_WAN_TIERS - 1];
+  };
+  vector<pair<int, int> > links;
+  vector<double> capacities;
+  links.reserve(nodes * average_degree / 2);
+  capacities.reserve(links.capacity());
+  DisjointSets components(nodes);
+  auto add_link = [&](int a, int b) {
+    links.push_back(make_pair(a, b));
+    capacities.push_back(draw_capacity());
+    components.Union(a, b);
+  };
+  for(int node = 0; node < nodes; node++) {
+    const int cx = cell_of(x[node]), cy = cell_of(y[node]);
+    for(int ny = max(cy - 1, 0); ny <= min(cy + 1, cells - 1); ny++) {
+      for(int nx = max(cx - 1, 0); nx <= min(cx + 1, cells - 1); nx++) {
+        const int cell = ny * cells + nx;
+        for(int index = cell_offsets[cell]; index < cell_offsets[cell + 1]; index++) {
+          const int other = cell_nodes[index];
+          if(other > node && distance(node, other) <= radius) {
+            add_link(node, other);
+          }
+        }
+      }
+    }
+  }
+  // Closest node to the given one outside its component if there is one closer than the
+  // bound, searching the perimeters of growing squares of cells around it.
+  vector<int> component(nodes);
+  auto closest_outside = [&](int node, double& closest_distance) {
+    const int cx = cell_of(x[node]), cy = cell_of(y[node]);
+    int closest = -1;
+    auto visit = [&](int nx, int ny) {
+      if(nx < 0 || nx >= cells) {
+        return;
+      }
+      const int cell = ny * cells + nx;
+      for(int index = cell_offsets[cell]; index < cell_offsets[cell + 1]; index++) {
+        const int other = cell_nodes[index];
+        if(component[other] != component[node] && distance(node, other) < closest_distance) {
+          closest = other;
+          closest_distance = distance(node, other);
+        }
+      }
+    };
+    for(int ring = 0; ring < cells && closest_distance > (ring - 1) * cell_size; ring++) {
+      for(int ny = max(cy - ring, 0); ny <= min(cy + ring, cells - 1); ny++) {
+        if(abs(ny - cy) == ring) {
+          for(int nx = max(cx - ring, 0); nx <= min(cx + ring, cells - 1); nx++) {
+            visit(nx, ny);
+          }
+        } else {
+          visit(cx - ring, ny);
+          visit(cx + ring, ny);
+        }
+      }
+    }
+    return closest;
+  };
+  // Join the components in rounds (Boruvka): every component but the largest links to the
+  // closest node outside it, so the number of components at least halves every round.
+  while(true) {
+    vector<int> sizes(nodes, 0);
+    for(int node = 0; node < nodes; node++) {
+      component[node] = components.Find(node);
+      sizes[component[node]]++;
+    }
+    const int largest = max_element(sizes.begin(), sizes.end()) - sizes.begin();
+    if(sizes[largest] == nodes) {
+      break;
+    }
+    vector<double> best_distance(nodes, numeric_limits<double>::infinity());
+    vector<pair<int, int> > best_link(nodes, make_pair(-1, -1));
+    for(int node = 0; node < nodes; node++) {
+      if(component[node] == largest) {
+        continue;
+      }
+      // Only a node closer than the best one found for the component so far matters.
+      double closest_distance = best_distance[component[node]];
+      const int closest = closest_outside(node, closest_distance);
+      if(closest >= 0) {
+        best_distance[component[node]] = closest_distance;
+        best_link[component[node]] = make_pair(node, closest);
+      }
+    }
+    for(const pair<int, int>& link : best_link) {
+      if(link.first >= 0 && components.Find(link.first) != components.Find(link.second)) {
+        add_link(link.first, link.second);
+      }
+    }
+  }
+  return BuildFromLinks(nodes, "GeometricWAN_" + to_string(nodes), links, capacities);
+}
+
+} // namespace Network
@@ -0,0 +1,44 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef TOPOLOGY_GENERATORS_HPP
+#define TOPOLOGY_GENERATORS_HPP
+
+#include <cstdint>
+
+#include "topology.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Capacity tiers of the links of a random geometric WAN, relative to the fastest one, and the
+// fraction of links in each tier.
+constexpr int GEOMETRIC_WAN_TIERS = 3;
+constexpr double GEOMETRIC_WAN_CAPACITIES[GEOMETRIC_WAN_TIERS] = {1.0, 0.4, 0.1};
+constexpr double GEOMETRIC_WAN_TIER_SHARES[GEOMETRIC_WAN_TIERS] = {0.2, 0.3, 0.5};
+
+// Synthetic topologies for scaling studies, built straight into a Topology in time close to
+// linear in the number of links. Every link is an edge in each direction and the same
+// parameters and seed always give the same topology.
+
+// k-ary fat-tree (k even): (k/2)^2 core switches numbered first, then k pods of k/2
+// aggregation followed by k/2 edge switches, then with hosts, k/2 hosts per edge switch.
+// All links have the given capacity.
+Topology* BuildFatTree(int k, bool hosts = true, double capacity = 1.0);
+
+// Jellyfish: a random regular graph of switches with `degree` ports each for the network. A
+// port stays free if switches * degree is odd and, rarely in small dense graphs, when no link
+// can be rewired to use it. All links have the given capacity.
+Topology* BuildJellyfish(int switches, int degree, uint64_t seed, double capacity = 1.0);
+
+// Random geometric WAN: nodes are placed uniformly on the unit square and every pair closer
+// than the radius that gives the average degree is linked. Components are then joined through
+// their closest nodes so that the network is connected. Capacities are drawn from the tiers
+// above.
+Topology* BuildGeometricWAN(int nodes, double average_degree, uint64_t seed);
+
+} // namespace Network
+
+#endif // TOPOLOGY_GENERATORS_HPP
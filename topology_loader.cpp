@@ -0,0 +1,504 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "topology_loader.hpp"
+
+namespace Network {
+
+namespace {
+
+// Topology files come from outside the program, anything wrong with one is reported with
+// the file name and, where there is one, the line.
+[[noreturn]] void Fail(const string& filename, int line, const string& message) {
+  throw runtime_error(filename + (line > 0 ? ":" + to_string(line) : "") + ": " + message);
+}
+
+// Read-only mapping of a whole text file.
+class MappedText {
+public:
+  explicit MappedText(const string& filename) : data_(NULL), length_(0) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      Fail(filename, 0, strerror(errno));
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0) {
+      const int error = errno;
+      close(fd);
+      Fail(filename, 0, strerror(error));
+    }
+    length_ = info.st_size;
+    if(length_ > 0) {
+      data_ = mmap(NULL, length_, PROT_READ, MAP_SHARED, fd, 0);
+      if(data_ == MAP_FAILED) {
+        const int error = errno;
+        close(fd);
+        length_ = 0;
+        Fail(filename, 0, strerror(error));
+      }
+      madvise(data_, length_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+  ~MappedText() {
+    if(length_ > 0) {
+      munmap(data_, length_);
+    }
+  }
+  const char* begin() const {
+    return static_cast<const char*>(data_);
+  }
+  const char* end() const {
+    return begin() + length_;
+  }
+private:
+  void* data_;
+  size_t length_;
+};
+
+typedef pair<const char*, const char*> Token;
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// The next whitespace separated token in [cursor, end), empty if there is none.
+Token NextToken(const char*& cursor, const char* end) {
+  while(cursor < end && IsSpace(*cursor)) {
+    cursor++;
+  }
+  const char* start = cursor;
+  while(cursor < end && !IsSpace(*cursor)) {
+    cursor++;
+  }
+  return Token(start, cursor);
+}
+
+bool TokenIs(const Token& token, const char* text) {
+  const size_t length = strlen(text);
+  return static_cast<size_t>(token.second - token.first) == length && memcmp(token.first, text, length) == 0;
+}
+
+// A non-negative decimal int, false if the token is anything else.
+bool ParseInt(const Token& token, int& value) {
+  if(token.first == token.second) {
+    return false;
+  }
+  long long parsed = 0;
+  for(const char* c = token.first; c < token.second; c++) {
+    if(*c < '0' || *c > '9') {
+      return false;
+    }
+    parsed = parsed * 10 + (*c - '0');
+    if(parsed > INT_MAX) {
+      return false;
+    }
+  }
+  value = parsed;
+  return true;
+}
+
+// A finite number, false if the token is anything else.
+bool ParseDouble(const Token& token, double& value) {
+  // The mapping is not null terminated, strtod gets a copy.
+  char buffer[64];
+  const size_t length = token.second - token.first;
+  if(length == 0 || length >= sizeof(buffer)) {
+    return false;
+  }
+  memcpy(buffer, token.first, length);
+  buffer[length] = '\0';
+  char* parsed;
+  value = strtod(buffer, &parsed);
+  return parsed == buffer + length && isfinite(value);
+}
+
+string TokenString(const Token& token) {
+  return string(token.first, token.second);
+}
+
+string FileStem(const string& filename) {
+  const size_t slash = filename.find_last_of('/');
+  const size_t start = (slash == string::npos) ? 0 : slash + 1;
+  const size_t dot = filename.find_last_of('.');
+  return filename.substr(start, (dot == string::npos || dot < start) ? string::npos : dot - start);
+}
+
+// Replace the predefined XML entities.
+string Unescape(const char* begin, const char* end) {
+  static const pair<const char*, char> entities[] = {
+    {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+  string text;
+  text.reserve(end - begin);
+  for(const char* c = begin; c < end; c++) {
+    bool replaced = false;
+    if(*c == '&') {
+      for(const pair<const char*, char>& entity : entities) {
+        const size_t length = strlen(entity.first);
+        if(static_cast<size_t>(end - c) >= length && memcmp(c, entity.first, length) == 0) {
+          text.push_back(entity.second);
+          c += length - 1;
+          replaced = true;
+          break;
+        }
+      }
+    }
+    if(!replaced) {
+      text.push_back(*c);
+    }
+  }
+  return text;
+}
+
+struct XMLTag {
+  string name;
+  bool closing;      // </name>
+  bool self_closing; // <name ... />
+  vector<pair<string, string> > attributes;
+  // Value of an attribute or empty if the tag does not have it.
+  string Attribute(const char* key) const {
+    for(const pair<string, string>& attribute : attributes) {
+      if(attribute.first == key) {
+        return attribute.second;
+      }
+    }
+    return "";
+  }
+};
+
+// Goes over the tags of an XML document one at a time, enough of XML for GraphML.
+class XMLScanner {
+public:
+  XMLScanner(const string& filename, const char* begin, const char* end) :
+    filename_(filename), begin_(begin), cursor_(begin), end_(end) {}
+  // Read the next tag, skipping text, comments, declarations and processing instructions.
+  // False at the end of the document.
+  bool Next(XMLTag& tag) {
+    while(true) {
+      cursor_ = static_cast<const char*>(memchr(cursor_, '<', end_ - cursor_));
+      if(cursor_ == NULL) {
+        cursor_ = end_;
+        return false;
+      }
+      if(end_ - cursor_ >= 4 && memcmp(cursor_, "<!--", 4) == 0) {
+        const char* comment_end = search(cursor_ + 4, end_, "-->", "-->" + 3);
+        if(comment_end == end_) {
+          Fail("unterminated comment");
+        }
+        cursor_ = comment_end + 3;
+      } else if(end_ - cursor_ >= 2 && (cursor_[1] == '?' || cursor_[1] == '!')) {
+        Skip('>');
+      } else {
+        break;
+      }
+    }
+    cursor_++;
+    tag.closing = Peek() == '/';
+    if(tag.closing) {
+      cursor_++;
+    }
+    tag.self_closing = false;
+    tag.attributes.clear();
+    tag.name = ReadName();
+    while(true) {
+      SkipSpaces();
+      if(Peek() == '>') {
+        cursor_++;
+        return true;
+      }
+      if(Peek() == '/') {
+        cursor_++;
+        if(Peek() != '>') {
+          Fail("expected '>' after '/' in <" + tag.name + ">");
+        }
+        cursor_++;
+        tag.self_closing = true;
+        return true;
+      }
+      string key = ReadName();
+      SkipSpaces();
+      if(Peek() != '=') {
+        Fail("expected '=' after attribute " + key + " of <" + tag.name + ">");
+      }
+      cursor_++;
+      SkipSpaces();
+      const char quote = Peek();
+      if(quote != '"' && quote != '\'') {
+        Fail("expected a quoted value for attribute " + key + " of <" + tag.name + ">");
+      }
+      cursor_++;
+      const char* value = cursor_;
+      Skip(quote);
+      tag.attributes.emplace_back(move(key), Unescape(value, cursor_ - 1));
+    }
+  }
+  // The text from the end of the last tag to the next one, without surrounding whitespace.
+  string Text() {
+    const char* text_end = static_cast<const char*>(memchr(cursor_, '<', end_ - cursor_));
+    if(text_end == NULL) {
+      text_end = end_;
+    }
+    const char* begin = cursor_;
+    const Token token = NextToken(begin, text_end);
+    const char* end = text_end;
+    while(end > token.first && IsSpace(end[-1])) {
+      end--;
+    }
+    return Unescape(token.first, end);
+  }
+  // Line of the cursor, counted only when something is reported.
+  int Line() const {
+    return count(begin_, cursor_, '\n') + 1;
+  }
+  [[noreturn]] void Fail(const string& message) const {
+    Network::Fail(filename_, Line(), message);
+  }
+private:
+  char Peek() const {
+    if(cursor_ >= end_) {
+      Fail("unexpected end of file inside a tag");
+    }
+    return *cursor_;
+  }
+  void SkipSpaces() {
+    while(IsSpace(Peek())) {
+      cursor_++;
+    }
+  }
+  // Move past the next occurrence of the character.
+  void Skip(char c) {
+    const char* found = static_cast<const char*>(memchr(cursor_, c, end_ - cursor_));
+    if(found == NULL) {
+      Fail(string("unexpected end of file, expected '") + c + "'");
+    }
+    cursor_ = found + 1;
+  }
+  string ReadName() {
+    const char* start = cursor_;
+    while(!IsSpace(Peek()) && Peek() != '=' && Peek() != '/' && Peek() != '>') {
+      cursor_++;
+    }
+    if(cursor_ == start) {
+      Fail(string("expected a name, found '") + *cursor_ + "'");
+    }
+    return string(start, cursor_);
+  }
+  const string filename_;
+  const char* const begin_;
+  const char* cursor_;
+  const char* const end_;
+};
+
+} // namespace
+
+Topology* LoadTopology(const string& filename) {
+  const string extension = ".graphml";
+  const bool graphml = filename.size() >= extension.size() &&
+    filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+  return graphml ? LoadGraphML(filename) : LoadEdgeList(filename);
+}
+
+Topology* LoadEdgeList(const string& filename) {
+  const MappedText text(filename);
+  const char* cursor = text.begin();
+  const char* const end = text.end();
+  string name = FileStem(filename);
+  int nodes = 0;
+  bool directed = false;
+  unique_ptr<Topology> topo;
+  for(int line = 1; cursor < end; line++) {
+    const char* line_end = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+    if(line_end == NULL) {
+      line_end = end;
+    }
+    const char* comment = static_cast<const char*>(memchr(cursor, '#', line_end - cursor));
+    const char* const data_end = (comment == NULL) ? line_end : comment;
+    const Token first = NextToken(cursor, data_end);
+    const bool directive = TokenIs(first, "name") || TokenIs(first, "nodes") || TokenIs(first, "directed");
+    if(directive && topo != NULL) {
+      Fail(filename, line, TokenString(first) + " must come before the first link");
+    }
+    if(first.first == first.second) {
+      // Blank line or comment.
+    } else if(TokenIs(first, "name")) {
+      const Token value = NextToken(cursor, data_end);
+      if(value.first == value.second) {
+        Fail(filename, line, "name without a value");
+      }
+      name = TokenString(value);
+    } else if(TokenIs(first, "nodes")) {
+      const Token value = NextToken(cursor, data_end);
+      if(!ParseInt(value, nodes) || nodes == 0) {
+        Fail(filename, line, "expected a positive node count, found '" + TokenString(value) + "'");
+      }
+    } else if(TokenIs(first, "directed")) {
+      directed = true;
+    } else {
+      if(topo == NULL) {
+        if(nodes == 0) {
+          Fail(filename, line, "link before the nodes directive");
+        }
+        topo.reset(new Topology(nodes, name));
+        // No line left holds more than one link.
+        const long long links = count(cursor, end, '\n') + 1;
+        topo->ReserveEdges(min<long long>(directed ? links : 2 * links, INT_MAX));
+      }
+      const Token dst_token = NextToken(cursor, data_end);
+      const Token capacity_token = NextToken(cursor, data_end);
+      int src, dst;
+      double capacity;
+      if(!ParseInt(first, src) || !ParseInt(dst_token, dst)) {
+        Fail(filename, line, "expected '<src> <dst> <capacity>' or a directive, found '" +
+             string(first.first, dst_token.second) + "'");
+      }
+      if(src >= nodes || dst >= nodes) {
+        Fail(filename, line, "node " + to_string(max(src, dst)) + " is out of range, there are " +
+             to_string(nodes) + " nodes");
+      }
+      if(src == dst) {
+        Fail(filename, line, "self loop on node " + to_string(src));
+      }
+      if(!ParseDouble(capacity_token, capacity) || capacity <= 0.0) {
+        Fail(filename, line, "expected a positive capacity, found '" + TokenString(capacity_token) + "'");
+      }
+      // Undirected links are added both ways, so either order of the nodes is found.
+      if(topo->GetEdgeID(src, dst) >= 0) {
+        Fail(filename, line, "link " + to_string(src) + (directed ? " -> " : " - ") + to_string(dst) +
+             " is listed twice");
+      }
+      if(directed) {
+        topo->AddEdge(topo->GetNode(src), topo->GetNode(dst), capacity);
+      } else {
+        topo->AddBidirectionalEdge(topo->GetNode(src), topo->GetNode(dst), capacity);
+      }
+    }
+    const Token rest = NextToken(cursor, data_end);
+    if(rest.first != rest.second) {
+      Fail(filename, line, "unexpected '" + TokenString(rest) + "' at the end of the line");
+    }
+    cursor = line_end + 1;
+  }
+  if(topo == NULL) {
+    if(nodes == 0) {
+      Fail(filename, 0, "no nodes directive");
+    }
+    topo.reset(new Topology(nodes, name));
+  }
+  return topo.release();
+}
+
+Topology* LoadGraphML(const string& filename) {
+  struct Link {
+    int src, dst;
+    double speed; // Sum of the known speeds of the parallel links, 0 if there is none.
+  };
+  const MappedText text(filename);
+  XMLScanner scanner(filename, text.begin(), text.end());
+  XMLTag tag;
+  string name = FileStem(filename);
+  string speed_key, name_key;
+  bool directed = false;
+  unordered_map<string, int> node_ids;
+  vector<Link> links;
+  unordered_map<long long, int> link_ids; // Node pair to index in links.
+  int current_link = -1; // Link of the edge being read.
+  auto node_id = [&](const string& id, const char* attribute) {
+    if(id.empty()) {
+      scanner.Fail(string("missing ") + attribute + " attribute in <" + tag.name + ">");
+    }
+    return node_ids.emplace(id, node_ids.size()).first->second;
+  };
+  while(scanner.Next(tag)) {
+    if(tag.closing) {
+      if(tag.name == "edge") {
+        current_link = -1;
+      }
+    } else if(tag.name == "key") {
+      const string attribute = tag.Attribute("attr.name");
+      const string scope = tag.Attribute("for");
+      if(attribute == "LinkSpeedRaw" && scope == "edge") {
+        speed_key = tag.Attribute("id");
+      } else if(attribute == "Network" && scope == "graph") {
+        name_key = tag.Attribute("id");
+      }
+    } else if(tag.name == "graph") {
+      directed = tag.Attribute("edgedefault") == "directed";
+    } else if(tag.name == "node") {
+      node_id(tag.Attribute("id"), "id");
+    } else if(tag.name == "edge") {
+      int src = node_id(tag.Attribute("source"), "source");
+      int dst = node_id(tag.Attribute("target"), "target");
+      current_link = -1;
+      if(src != dst) {
+        if(!directed && src > dst) {
+          swap(src, dst);
+        }
+        const long long key = (static_cast<long long>(src) << 32) | dst;
+        auto inserted = link_ids.emplace(key, links.size());
+        if(inserted.second) {
+          links.push_back({src, dst, 0.0});
+        }
+        current_link = inserted.first->second;
+      }
+      if(tag.self_closing) {
+        current_link = -1;
+      }
+    } else if(tag.name == "data" && !tag.self_closing) {
+      const string key = tag.Attribute("key");
+      if(!speed_key.empty() && key == speed_key && current_link >= 0) {
+        const string text = scanner.Text();
+        double speed;
+        if(!ParseDouble(Token(text.data(), text.data() + text.size()), speed) || speed < 0.0) {
+          scanner.Fail("expected a non-negative link speed, found '" + text + "'");
+        }
+        links[current_link].speed += speed;
+      } else if(!name_key.empty() && key == name_key) {
+        name = scanner.Text();
+      }
+    }
+  }
+  if(node_ids.empty()) {
+    Fail(filename, 0, "no nodes");
+  }
+  double fastest = 0.0;
+  int unknown_speeds = 0;
+  for(const Link& link : links) {
+    fastest = max(fastest, link.speed);
+    unknown_speeds += (link.speed == 0.0);
+  }
+  if(fastest > 0.0 && unknown_speeds > 0) {
+    cerr << filename << ": " << unknown_speeds << " of " << links.size() << " links have no "
+         << "LinkSpeedRaw, they get the capacity of the fastest link" << endl;
+  }
+  Topology* topo = new Topology(node_ids.size(), name);
+  topo->ReserveEdges(directed ? links.size() : 2 * links.size());
+  for(const Link& link : links) {
+    const double capacity = (link.speed > 0.0) ? link.speed / fastest : 1.0;
+    if(directed) {
+      topo->AddEdge(topo->GetNode(link.src), topo->GetNode(link.dst), capacity);
+    } else {
+      topo->AddBidirectionalEdge(topo->GetNode(link.src), topo->GetNode(link.dst), capacity);
+    }
+  }
+  return topo;
+}
+
+} // namespace Network
@@ -0,0 +1,42 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef TOPOLOGY_LOADER_HPP
+#define TOPOLOGY_LOADER_HPP
+
+#include <string>
+
+#include "topology.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Topology files are read in one pass straight into a new Topology, edges are added in the
+// order they appear in the file.
+//
+// Edge lists have one directive or link per line, '#' starts a comment:
+//   name <name>               Optional, the file name without directory and extension by default.
+//   nodes <count>             Required before the first link, nodes are numbered from 0.
+//   directed                  Optional, before the first link: every link is a single edge.
+//   <src> <dst> <capacity>    A link, an edge in each direction unless the file is directed.
+// A link is listed once, "b a" repeats "a b" unless the file is directed. Unlike GraphML
+// files, parallel links are an error rather than merged.
+//
+// GraphML files as in the Internet Topology Zoo: nodes are numbered in the order they first
+// appear, the "Network" data of the graph is its name and capacities are the "LinkSpeedRaw"
+// data of the links relative to the fastest link. Links without a speed (or a zero one) get
+// capacity 1, like the fastest link, and are counted in a warning on stderr unless no link
+// has a speed. Parallel links are merged into one with the sum of their speeds and self
+// loops are dropped.
+//
+// A file that cannot be read or is malformed throws runtime_error with the file name and
+// line in its message.
+Topology* LoadTopology(const string& filename); // GraphML if it ends in .graphml, else edge list.
+Topology* LoadEdgeList(const string& filename);
+Topology* LoadGraphML(const string& filename);
+
+} // namespace Network
+
+#endif // TOPOLOGY_LOADER_HPP
@@ -0,0 +1,182 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "trace.hpp"
+
+using namespace std;
+
+namespace Network {
+
+namespace {
+
+void ThrowFileError(const string& filename, const string& message) {
+  throw runtime_error(filename + ": " + message);
+}
+
+bool WriteTraceHeader(FILE* file, const char* magic, uint32_t version, uint32_t record_size, uint64_t count) {
+  TraceHeader header = {};
+  memcpy(header.magic, magic, sizeof(header.magic));
+  header.version = version;
+  header.record_size = record_size;
+  header.count = count;
+  return fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+} // namespace
+
+FILE* CreateRecordFile(const string& filename) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if(file == NULL) {
+    ThrowFileError(filename, strerror(errno));
+  }
+  // Placeholder header, rewritten with the final count on close.
+  const TraceHeader header = {};
+  if(fwrite(&header, sizeof(header), 1, file) != 1) {
+    fclose(file);
+    ThrowFileError(filename, "cannot write the header");
+  }
+  return file;
+}
+
+void CloseRecordFile(FILE* file, const string& filename, const char* magic, uint32_t version,
+                     uint32_t record_size, uint64_t count) {
+  const bool header_written = WriteTraceHeader(file, magic, version, record_size, count);
+  if(fclose(file) != 0 || !header_written) {
+    ThrowFileError(filename, "cannot write the file");
+  }
+}
+
+TraceWriter::TraceWriter(const string& filename) :
+  filename_(filename), file_(CreateRecordFile(filename)), count_(0), last_arrival_(0.0) {}
+
+TraceWriter::~TraceWriter() {
+  try {
+    Close();
+  } catch(const runtime_error& error) {
+    cerr << error.what() << endl;
+  }
+}
+
+void TraceWriter::Write(const FlowArrival& flow) {
+  assert(file_ != NULL);
+  assert(flow.arrival >= last_arrival_);
+  last_arrival_ = flow.arrival;
+  if(fwrite(&flow, sizeof(flow), 1, file_) != 1) {
+    ThrowFileError(filename_, "cannot write a flow");
+  }
+  count_++;
+}
+
+void TraceWriter::Close() {
+  if(file_ == NULL) {
+    return;
+  }
+  FILE* const file = file_;
+  file_ = NULL;
+  CloseRecordFile(file, filename_, TRACE_MAGIC, TRACE_VERSION, sizeof(FlowArrival), count_);
+}
+
+uint64_t WriteTrace(const string& filename, TrafficSource& source) {
+  TraceWriter writer(filename);
+  uint64_t count = 0;
+  while(source.HasNext()) {
+    writer.Write(source.Next());
+    count++;
+  }
+  writer.Close();
+  return count;
+}
+
+MappedRecordFile::MappedRecordFile(const string& filename, const char* magic, uint32_t version, uint32_t record_size) : 
+  records_(NULL), count_(0), filename_(filename), data_(NULL), length_(0) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if(fd < 0) {
+    ThrowFileError(filename, strerror(errno));
+  }
+  struct stat info;
+  if(fstat(fd, &info) != 0) {
+    const int error = errno;
+    close(fd);
+    ThrowFileError(filename, strerror(error));
+  }
+  length_ = info.st_size;
+  if(length_ < sizeof(TraceHeader)) {
+    close(fd);
+    ThrowFileError(filename, "shorter than the header");
+  }
+  data_ = mmap(NULL, length_, PROT_READ, MAP_SHARED, fd, 0);
+  const int error = errno;
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if(data_ == MAP_FAILED) {
+    ThrowFileError(filename, strerror(error));
+  }
+  // The destructor does not run if the constructor throws.
+  auto fail = [this](const string& message) {
+    munmap(data_, length_);
+    ThrowFileError(filename_, message);
+  };
+  const TraceHeader* header = static_cast<const TraceHeader*>(data_);
+  if(memcmp(header->magic, magic, sizeof(header->magic)) != 0) {
+    fail("not a " + string(magic, sizeof(header->magic)) + " file");
+  }
+  if(header->version != version) {
+    fail("version " + to_string(header->version) + ", expected " + to_string(version));
+  }
+  if(header->record_size != record_size) {
+    fail("records of " + to_string(header->record_size) + " bytes, expected " + to_string(record_size));
+  }
+  count_ = header->count;
+  if(count_ != (length_ - sizeof(TraceHeader)) / record_size ||
+     (length_ - sizeof(TraceHeader)) % record_size != 0) {
+    fail("truncated, " + to_string(length_) + " bytes for " + to_string(count_) + " records");
+  }
+  records_ = static_cast<const char*>(data_) + sizeof(TraceHeader);
+  // Records are read front to back.
+  madvise(data_, length_, MADV_SEQUENTIAL);
+}
+
+MappedRecordFile::~MappedRecordFile() {
+  munmap(data_, length_);
+}
+
+MappedTrace::MappedTrace(const string& filename) : 
+  MappedRecordFile(filename, TRACE_MAGIC, TRACE_VERSION, sizeof(FlowArrival)) {}
+
+TraceTrafficSource::TraceTrafficSource(const MappedTrace& trace, const Scenario& scenario) :
+  cursor_(trace.begin()), end_(trace.end()), sim_duration_(scenario.sim_duration),
+  nodes_(scenario.topo->GetNodes().size()), filename_(trace.GetFilename()) {}
+
+bool TraceTrafficSource::HasNext() const {
+  return cursor_ != end_ && cursor_->arrival < sim_duration_;
+}
+
+const FlowArrival& TraceTrafficSource::Peek() const {
+  assert(HasNext());
+  return *cursor_;
+}
+
+FlowArrival TraceTrafficSource::Next() {
+  const FlowArrival flow = Peek();
+  if(flow.src < 0 || flow.src >= nodes_ || flow.dst < 0 || flow.dst >= nodes_) {
+    ThrowFileError(filename_, "flow " + to_string(count_) + " goes from node " + to_string(flow.src) + " to node " +
+                   to_string(flow.dst) + ", the topology has " + to_string(nodes_) + " nodes");
+  }
+  cursor_++;
+  count_++;
+  return flow;
+}
+
+} // namespace Network
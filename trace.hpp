@@ -0,0 +1,119 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+#include "simulator.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Binary trace of flow arrivals. The file is a TraceHeader followed by `count` FlowArrival
+// records (arrival, volume, src, dst) in arrival order, all in the byte order of the
+// machine that wrote it. Records are read in place from a read-only mapping.
+constexpr char TRACE_MAGIC[8] = {'B', 'W', 'R', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+// Header of the binary files of fixed-size records (traces and flow records).
+struct TraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size; // sizeof of the record, rejects files from a different layout.
+  uint64_t count;
+};
+
+static_assert(is_trivially_copyable<FlowArrival>::value && sizeof(FlowArrival) == 24,
+              "FlowArrival is the on-disk record of a trace");
+static_assert(sizeof(TraceHeader) % alignof(FlowArrival) == 0, "Records must stay aligned");
+
+// Appends flows to a new trace file. The record count in the header is filled in on Close.
+// A file that cannot be created or written throws runtime_error with the file name, except
+// when closing from the destructor, which reports it on stderr.
+class TraceWriter {
+public:
+  explicit TraceWriter(const string& filename);
+  ~TraceWriter();
+  // Flows must be written in arrival order.
+  void Write(const FlowArrival& flow);
+  void Close();
+private:
+  const string filename_;
+  FILE* file_;
+  uint64_t count_;
+  double last_arrival_;
+};
+
+// Write every flow of a source into a trace file and return the number of flows.
+uint64_t WriteTrace(const string& filename, TrafficSource& source);
+
+// Create a file of records, starting with a placeholder header.
+FILE* CreateRecordFile(const string& filename);
+// Write the header of the count records written to a file and close it.
+void CloseRecordFile(FILE* file, const string& filename, const char* magic, uint32_t version,
+                     uint32_t record_size, uint64_t count);
+
+// Read-only memory mapping of a file of fixed-size records behind a TraceHeader with the
+// given magic and version. Opening is constant time regardless of the file length, and one
+// mapping can be read by any number of threads at once. A file that cannot be mapped, has
+// another magic, version or record size, or is not as long as its count says throws
+// runtime_error with the file name.
+class MappedRecordFile {
+public:
+  MappedRecordFile(const string& filename, const char* magic, uint32_t version, uint32_t record_size);
+  ~MappedRecordFile();
+  MappedRecordFile(const MappedRecordFile&) = delete;
+  MappedRecordFile& operator=(const MappedRecordFile&) = delete;
+  uint64_t Size() const {
+    return count_;
+  }
+  const string& GetFilename() const {
+    return filename_;
+  }
+protected:
+  const void* records_;
+  uint64_t count_;
+private:
+  const string filename_;
+  void* data_;
+  size_t length_;
+};
+
+// Mapping of a trace file.
+class MappedTrace : public MappedRecordFile {
+public:
+  explicit MappedTrace(const string& filename);
+  const FlowArrival* begin() const {
+    return static_cast<const FlowArrival*>(records_);
+  }
+  const FlowArrival* end() const {
+    return begin() + count_;
+  }
+};
+
+// Replays the flows of a mapped trace that arrive within the scenario duration. A flow with
+// a node outside the scenario topology throws runtime_error from Next.
+class TraceTrafficSource : public TrafficSource {
+public:
+  TraceTrafficSource(const MappedTrace& trace, const Scenario& scenario);
+  bool HasNext() const override;
+  const FlowArrival& Peek() const override;
+  FlowArrival Next() override;
+private:
+  const FlowArrival* cursor_;
+  const FlowArrival* const end_;
+  const double sim_duration_;
+  const int nodes_;
+  const string filename_;
+};
+
+} // namespace Network
+
+#endif // TRACE_HPP
@@ -0,0 +1,314 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "water_filling.hpp"
+
+using namespace std;
+
+namespace Network {
+
+namespace {
+
+// Root of an item in a union-find forest, halving the path on the way.
+int FindRoot(vector<int>& parent, int item) {
+  while(parent[item] != item) {
+    parent[item] = parent[parent[item]];
+    item = parent[item];
+  }
+  return item;
+}
+
+} // namespace
+
+WaterFilling::WaterFilling(Topology* topo) : topo_(topo) {}
+
+WaterFilling::~WaterFilling() {}
+
+void WaterFilling::SetThreads(int threads) {
+  if(threads == 1) {
+    pool_.reset();
+  } else {
+    pool_.reset(new ThreadPool(threads));
+  }
+}
+
+// Flatten the flows, paths and (edge, flow) pairs into arrays indexed by integers.
+void WaterFilling::Build(const unordered_map<int, Flow*>& flows, double duration) {
+  const CSRGraph& csr = topo_->GetCSR();
+  const int num_edges = csr.NumEdges();
+  flow_demand_.clear();
+  flow_paths_begin_.clear();
+  paths_.clear();
+  path_edges_.clear();
+  path_entries_.clear();
+  entries_.clear();
+  entries_edge_.clear();
+  last_flow_.assign(num_edges, -1);
+  last_entry_.assign(num_edges, -1);
+  for(const pair<const int, Flow*>& flow_pair : flows) {
+    Flow* const flow = flow_pair.second;
+    const int flow_index = flow_demand_.size();
+    flow_demand_.push_back(isinf(duration) ? 
+      numeric_limits<double>::max() : flow->GetRemainingSize() / duration);
+    flow_paths_begin_.push_back(paths_.size());
+    for(Path* const path : flow->GetPaths()) {
+      PathState state = {path, flow_index, static_cast<int>(path_edges_.size()), 0, -1.0};
+      for(Edge* const edge : path->GetEdges()) {
+        const int edge_id = edge->GetID();
+        // All paths of a flow are visited back to back, so one entry per (edge, flow).
+        if(last_flow_[edge_id] != flow_index) {
+          last_flow_[edge_id] = flow_index;
+          last_entry_[edge_id] = entries_.size();
+          entries_.push_back({flow_index, 0, 0.0, false});
+          entries_edge_.push_back(edge_id);
+        }
+        entries_[last_entry_[edge_id]].active_paths++;
+        path_edges_.push_back(edge_id);
+        path_entries_.push_back(last_entry_[edge_id]);
+      }
+      state.end = path_edges_.size();
+      paths_.push_back(state);
+    }
+  }
+  flow_paths_begin_.push_back(paths_.size());
+  // Group the entries by edge, ordered by flow demand so that the smallest active demand
+  // on an edge can be found by advancing a cursor.
+  entries_begin_.assign(num_edges + 1, 0);
+  for(const int edge_id : entries_edge_) {
+    entries_begin_[edge_id + 1]++;
+  }
+  for(int edge_id = 0; edge_id < num_edges; edge_id++) {
+    entries_begin_[edge_id + 1] += entries_begin_[edge_id];
+  }
+  cursor_.assign(entries_begin_.begin(), entries_begin_.end() - 1);
+  entries_order_.resize(entries_.size());
+  for(size_t entry = 0; entry < entries_.size(); entry++) {
+    entries_order_[cursor_[entries_edge_[entry]]++] = entry;
+  }
+  residual_.resize(num_edges);
+  active_flows_.resize(num_edges);
+  partial_flows_.assign(num_edges, 0);
+  best_flow_.assign(num_edges, -1);
+  stamp_.assign(num_edges, 0);
+  touched_.assign(num_edges, 0);
+  for(int edge_id = 0; edge_id < num_edges; edge_id++) {
+    const int begin = entries_begin_[edge_id], end = entries_begin_[edge_id + 1];
+    stable_sort(entries_order_.begin() + begin, entries_order_.begin() + end,
+      [&](const int entry1, const int entry2) {
+        return flow_demand_[entries_[entry1].flow] < flow_demand_[entries_[entry2].flow];
+      });
+    cursor_[edge_id] = begin;
+    residual_[edge_id] = csr.capacities[edge_id];
+    active_flows_[edge_id] = end - begin;
+  }
+}
+
+void WaterFilling::BuildComponents() {
+  const int num_edges = active_flows_.size();
+  component_.resize(num_edges);
+  for(int edge_id = 0; edge_id < num_edges; edge_id++) {
+    component_[edge_id] = edge_id;
+  }
+  // All edges of all paths of a flow end up in the same component.
+  for(size_t flow = 0; flow + 1 < flow_paths_begin_.size(); flow++) {
+    int root = -1;
+    for(int path = flow_paths_begin_[flow]; path < flow_paths_begin_[flow + 1]; path++) {
+      for(int hop = paths_[path].begin; hop < paths_[path].end; hop++) {
+        const int edge_root = FindRoot(component_, path_edges_[hop]);
+        if(root < 0) {
+          root = edge_root;
+        } else if(edge_root != root) {
+          component_[edge_root] = root;
+        }
+      }
+    }
+  }
+  // Bucket the edges with active flows by root, largest components first so that the
+  // big ones are not left for last on the pool.
+  vector<int> sizes(num_edges, 0), roots;
+  for(int edge_id = 0; edge_id < num_edges; edge_id++) {
+    if(active_flows_[edge_id] == 0) {
+      continue;
+    }
+    const int root = FindRoot(component_, edge_id);
+    if(sizes[root]++ == 0) {
+      roots.push_back(root);
+    }
+  }
+  stable_sort(roots.begin(), roots.end(), [&](const int root1, const int root2) {
+    return sizes[root1] > sizes[root2];
+  });
+  vector<int> next(num_edges);
+  components_begin_.assign(1, 0);
+  for(const int root : roots) {
+    next[root] = components_begin_.back();
+    components_begin_.push_back(components_begin_.back() + sizes[root]);
+  }
+  component_edges_.resize(components_begin_.back());
+  for(int edge_id = 0; edge_id < num_edges; edge_id++) {
+    if(active_flows_[edge_id] > 0) {
+      component_edges_[next[FindRoot(component_, edge_id)]++] = edge_id;
+    }
+  }
+}
+
+void WaterFilling::Fill(Worker& worker, const int* edges_begin, const int* edges_end) {
+  worker.heap.clear();
+  worker.touch_stamp = 0;
+  for(const int* edge = edges_begin; edge != edges_end; edge++) {
+    Refresh(worker, *edge);
+  }
+  // Keep freezing the flow with the smallest share until no edge has active flows left.
+  while(!worker.heap.empty()) {
+    pop_heap(worker.heap.begin(), worker.heap.end(), HeapComp());
+    const HeapItem item = worker.heap.back();
+    worker.heap.pop_back();
+    const int edge = get<1>(item);
+    if(get<2>(item) != stamp_[edge]) {
+      continue;
+    }
+    Freeze(worker, edge, best_flow_[edge], get<0>(item));
+    Count(worker.counters, Counter::FLOWS_FROZEN);
+  }
+}
+
+void WaterFilling::Refresh(Worker& worker, int edge) {
+  stamp_[edge]++;
+  if(active_flows_[edge] == 0) {
+    return;
+  }
+  assert(residual_[edge] > -1E-6);
+  if(residual_[edge] < 1E-6) {
+    return;
+  }
+  const double fair_share = residual_[edge] / active_flows_[edge];
+  const int end = entries_begin_[edge + 1];
+  // Entries only ever turn inactive within a slot, so the cursor never moves back.
+  int& cursor = cursor_[edge];
+  while(cursor < end && entries_[entries_order_[cursor]].active_paths == 0) {
+    cursor++;
+  }
+  assert(cursor < end);
+  double min_share = numeric_limits<double>::max();
+  int min_flow = -1;
+  if(partial_flows_[edge] == 0) {
+    // No active flow has rate on this edge yet: the share is capped by the smallest demand.
+    const EdgeFlow& entry = entries_[entries_order_[cursor]];
+    min_share = min(fair_share, flow_demand_[entry.flow]);
+    min_flow = entry.flow;
+  } else {
+    for(int index = cursor; index < end; index++) {
+      const EdgeFlow& entry = entries_[entries_order_[index]];
+      if(entry.active_paths == 0) {
+        continue;
+      }
+      assert(fair_share - entry.used > -1E-6);
+      const double share = min(max(fair_share - entry.used, 0.0), flow_demand_[entry.flow]);
+      if(share < min_share) {
+        min_share = share;
+        min_flow = entry.flow;
+      }
+    }
+  }
+  best_flow_[edge] = min_flow;
+  worker.heap.push_back(make_tuple(min_share, edge, stamp_[edge]));
+  push_heap(worker.heap.begin(), worker.heap.end(), HeapComp());
+}
+
+void WaterFilling::Freeze(Worker& worker, int edge, int flow, double share) {
+  // Unassigned paths of this flow that go through the bottleneck edge. The min-hop ones
+  // split the share equally and the longer ones are given nothing.
+  worker.candidates.clear();
+  int min_hops = numeric_limits<int>::max(), num_min_paths = 0;
+  for(int path = flow_paths_begin_[flow]; path < flow_paths_begin_[flow + 1]; path++) {
+    const PathState& state = paths_[path];
+    if(state.rate >= 0.0 ||
+       find(path_edges_.begin() + state.begin, path_edges_.begin() + state.end, edge) ==
+          path_edges_.begin() + state.end) {
+      continue;
+    }
+    worker.candidates.push_back(path);
+    const int hops = state.end - state.begin;
+    if(hops < min_hops) {
+      min_hops = hops;
+      num_min_paths = 1;
+    } else if(hops == min_hops) {
+      num_min_paths++;
+    }
+  }
+  assert(!worker.candidates.empty());
+  worker.touch_stamp++;
+  worker.touched_edges.clear();
+  for(const int path : worker.candidates) {
+    PathState& state = paths_[path];
+    state.rate = (state.end - state.begin == min_hops) ? share / num_min_paths : 0.0;
+    for(int hop = state.begin; hop < state.end; hop++) {
+      const int edge_id = path_edges_[hop];
+      EdgeFlow& entry = entries_[path_entries_[hop]];
+      entry.used += state.rate;
+      entry.active_paths--;
+      if(entry.active_paths == 0) {
+        // The flow is done on this edge, its rate is no longer available to others.
+        active_flows_[edge_id]--;
+        residual_[edge_id] -= entry.used;
+        if(entry.partial) {
+          entry.partial = false;
+          partial_flows_[edge_id]--;
+        }
+      } else if(entry.used > 0.0 && !entry.partial) {
+        entry.partial = true;
+        partial_flows_[edge_id]++;
+      }
+      if(touched_[edge_id] != worker.touch_stamp) {
+        touched_[edge_id] = worker.touch_stamp;
+        worker.touched_edges.push_back(edge_id);
+      }
+    }
+  }
+  for(const int edge_id : worker.touched_edges) {
+    Refresh(worker, edge_id);
+  }
+}
+
+unordered_map<Path*, double> WaterFilling::Allocate(const unordered_map<int, Flow*>& flows, double duration) {
+  Build(flows, duration);
+  if(pool_ && entries_.size() >= WATER_FILLING_MIN_PARALLEL_ENTRIES) {
+    BuildComponents();
+    const int components = components_begin_.size() - 1;
+    if(workers_.size() < static_cast<size_t>(components)) {
+      workers_.resize(components);
+    }
+    pool_->ParallelFor(components, [&](int component) {
+      Fill(workers_[component], component_edges_.data() + components_begin_[component], 
+           component_edges_.data() + components_begin_[component + 1]);
+    });
+  } else {
+    if(workers_.empty()) {
+      workers_.resize(1);
+    }
+    all_edges_.resize(active_flows_.size());
+    for(size_t edge_id = 0; edge_id < all_edges_.size(); edge_id++) {
+      all_edges_[edge_id] = edge_id;
+    }
+    Fill(workers_[0], all_edges_.data(), all_edges_.data() + all_edges_.size());
+  }
+  for(Worker& worker : workers_) {
+    Collect(worker.counters);
+  }
+  unordered_map<Path*, double> path_allocated_rate;
+  for(const PathState& state : paths_) {
+    if(state.rate > 0) {
+      path_allocated_rate[state.path] = state.rate;
+    }
+  }
+  return path_allocated_rate;
+}
+
+} // namespace Network
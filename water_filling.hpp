@@ -0,0 +1,119 @@
+// Author: Mohammad Noormohammadpour
+// Copyright 2019
+// Can be distributed under MIT license (https://opensource.org/licenses/MIT)
+
+#ifndef WATER_FILLING_HPP
+#define WATER_FILLING_HPP
+
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "tools.hpp"
+#include "topology.hpp"
+
+using namespace std;
+
+namespace Network {
+
+// Below this many (edge, flow) pairs Allocate fills sequentially whatever the number of
+// threads, splitting into components would cost more than it saves.
+constexpr int WATER_FILLING_MIN_PARALLEL_ENTRIES = 2048;
+
+// Progressive-filling engine that computes max-min fair rates per path. It implements
+// the same policy as the original per-slot rebuild in FlowRouter::NextSlot: at every
+// step the (edge, flow) pair with the smallest fair share is frozen, and that share is
+// split equally across the flow's min-hop paths on the edge (longer paths get zero).
+//
+// Per-edge state (residual capacity, number of active flows) lives in flat arrays
+// indexed by edge id and the next bottleneck edge is taken from a min-heap. After a
+// flow is frozen only the edges on its newly assigned paths are re-evaluated.
+//
+// Flows that share no edge, directly or through other flows, never affect each other's
+// rates. With more than one thread the edges are split into such sharing components and
+// each component is filled on its own (with its own heap) on a thread pool. Every edge
+// goes through the same steps either way, so the rates are identical.
+class WaterFilling {
+public:
+  explicit WaterFilling(Topology* topo);
+  ~WaterFilling();
+  // Number of threads used by Allocate, 1 (the default) fills sequentially.
+  void SetThreads(int threads);
+  // Compute the rate of every path of the given flows for a timeslot of the given
+  // duration (flow demands are capped by what they can finish in that duration, an
+  // infinite duration leaves them uncapped).
+  // Paths that receive no capacity are not included in the output.
+  unordered_map<Path*, double> Allocate(const unordered_map<int, Flow*>& flows, double duration);
+private:
+  // One entry per (edge, flow) pair: all paths of a flow on an edge share it.
+  struct EdgeFlow {
+    int flow;         // Index into flow_demand_.
+    int active_paths; // Paths of this flow on this edge that are not assigned yet.
+    double used;      // Rate already assigned to this flow's paths on this edge.
+    bool partial;     // Still active but has some rate assigned (multipath only).
+  };
+  struct PathState {
+    Path* path;
+    int flow;
+    int begin, end; // Range in path_edges_ and path_entries_.
+    double rate;    // Negative while unassigned.
+  };
+  using HeapItem = tuple<double, int, int>; // <fair share, edge id, stamp>
+  using HeapComp = greater<HeapItem>;
+  // Scratch space of one filling loop, kept across calls.
+  struct Worker {
+    vector<HeapItem> heap;
+    vector<int> touched_edges;
+    vector<int> candidates;
+    int touch_stamp = 0;
+    Instrumentation counters; // Collected by the calling thread after the filling.
+  };
+
+  void Build(const unordered_map<int, Flow*>& flows, double duration);
+  // Group the edges with active flows into sharing components.
+  void BuildComponents();
+  // Run progressive filling over the given edges until none has active flows left.
+  void Fill(Worker& worker, const int* edges_begin, const int* edges_end);
+  // Re-evaluate the smallest fair share on an edge and push it to the heap.
+  void Refresh(Worker& worker, int edge);
+  // Freeze the flow that owns the smallest share on the given edge.
+  void Freeze(Worker& worker, int edge, int flow, double share);
+
+  Topology* topo_;
+  // Per flow.
+  vector<double> flow_demand_;
+  vector<int> flow_paths_begin_; // Range into paths_ (paths of a flow are contiguous).
+  // Per path.
+  vector<PathState> paths_;
+  vector<int> path_edges_;   // Edge id of every hop, per path.
+  vector<int> path_entries_; // EdgeFlow index of every hop, per path.
+  // Per edge.
+  vector<double> residual_;  // Capacity minus rates of flows no longer active on the edge.
+  vector<int> active_flows_;
+  vector<int> partial_flows_;
+  vector<int> entries_begin_; // Range into entries_order_ (sorted by demand).
+  vector<int> cursor_;        // First entry in entries_order_ that may still be active.
+  vector<int> best_flow_;     // Flow holding the smallest share at the last refresh.
+  vector<int> stamp_;         // Bumped on every refresh to invalidate stale heap items.
+  vector<int> last_flow_, last_entry_; // Used to merge paths of a flow into one entry.
+  vector<int> touched_;       // Touch stamp of the worker that last visited the edge.
+  vector<int> component_;     // Union-find parent while grouping edges into components.
+  // Per (edge, flow) pair.
+  vector<EdgeFlow> entries_;
+  vector<int> entries_edge_;
+  vector<int> entries_order_;
+  // Edges with active flows grouped by component, largest component first.
+  vector<int> component_edges_;
+  vector<int> components_begin_;
+  // Scratch space kept across calls, one worker per component.
+  vector<Worker> workers_;
+  vector<int> all_edges_;
+  unique_ptr<ThreadPool> pool_;
+};
+
+} // namespace Network
+
+#endif // WATER_FILLING_HPP